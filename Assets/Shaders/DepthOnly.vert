@@ -0,0 +1,32 @@
+#version 450 core
+
+layout (location = 0) in vec3 aPos;
+layout (location = 3) in uint aInstance; // Per-instance, offset by the draw base instance.
+
+// Must match the lit pass depth exactly for its GL_EQUAL depth test.
+invariant gl_Position;
+
+// Frame related (std140 layout of Renderer::FrameConstantsData).
+layout (std140, binding = 0) uniform FrameConstants
+{
+	mat4 view;
+	mat4 projection;
+	mat4 viewProj;
+	vec4 cameraPos;
+	vec4 time;     // x: time, y: delta time.
+	vec4 viewport; // xy: size, zw: inverse size.
+	vec4 clusters; // x: near, y: far, z: depth slice scale, w: depth slice bias.
+};
+
+// Instances related (std430 layout of Renderer::InstanceData).
+layout (std430, binding = 2) readonly buffer Instances
+{
+	mat4 models[];
+};
+
+void main()
+{
+	// Same transform as the vertex shader, from the position only stream.
+	vec4 worldPos = models[aInstance] * vec4(aPos, 1.0f);
+	gl_Position   = viewProj * worldPos;
+}
\ No newline at end of file
@@ -1,15 +1,20 @@
 #version 450 core
 
-#define MAX_LIGHTS 10
+#define CLUSTER_X 16
+#define CLUSTER_Y 9
+#define CLUSTER_Z 24
 
 // Shaders output.
 out vec4 fragColor;
 
-// Light structure.
+// Light structure (std430 layout of Renderer::LightData).
 struct Light 
 {
-	float innerCone, outerCone, range, linear, quadratic;
-	vec3 ambient, diffuse, specular, position, direction;
+	vec4 ambient;   // w: range.
+	vec4 diffuse;   // w: linear.
+	vec4 specular;  // w: quadratic.
+	vec4 position;  // w: inner cone.
+	vec4 direction; // w: outer cone.
 };
 
 // Shader inputs.
@@ -20,56 +25,100 @@ in vec3 normal;
 // Texture maps related.
 uniform sampler2D tex;
 
-// Camera related.
-uniform vec3 viewPos;
+// Frame related (std140 layout of Renderer::FrameConstantsData).
+layout (std140, binding = 0) uniform FrameConstants
+{
+	mat4 view;
+	mat4 projection;
+	mat4 viewProj;
+	vec4 cameraPos;
+	vec4 time;     // x: time, y: delta time.
+	vec4 viewport; // xy: size, zw: inverse size.
+	vec4 clusters; // x: near, y: far, z: depth slice scale, w: depth slice bias.
+};
 
 // Lights related.
-uniform Light lights[MAX_LIGHTS];
+layout (std430, binding = 1) readonly buffer Lights
+{
+	uint  lightCount;
+	Light lights[];
+};
+
+// Lights range of each cluster in the light indices list (x: offset, y: count).
+layout (std430, binding = 9) readonly buffer Clusters
+{
+	uvec2 clusterRanges[];
+};
+
+layout (std430, binding = 10) readonly buffer ClusterLights
+{
+	uint clusterLightCount;
+	uint clusterLights[];
+};
+
+// Froxel of the current pixel: screen tile and exponential view depth slice.
+uint computeCluster()
+{
+	float depth = 1.0 / gl_FragCoord.w;
+	uvec2 tile  = uvec2(gl_FragCoord.xy * viewport.zw * vec2(CLUSTER_X, CLUSTER_Y));
+	uint  slice = uint(clamp(log(depth) * clusters.z + clusters.w, 0.0, CLUSTER_Z - 1.0));
+
+	return min(tile.x, CLUSTER_X - 1) + min(tile.y, CLUSTER_Y - 1) * CLUSTER_X + slice * CLUSTER_X * CLUSTER_Y;
+}
 
-vec4 computeLight(Light light)
+vec3 computeLight(Light light, vec3 normal, vec3 viewDir)
 {
-	bool isDirectional = (light.direction != vec3(0.0, 0.0, 0.0));
-	bool isSpotlight   = (light.innerCone != 0.0 && light.outerCone != 0.0 && isDirectional);
+	float range = light.ambient.w, linear = light.diffuse.w, quadratic = light.specular.w;
+	float innerCone = light.position.w, outerCone = light.direction.w;
+	vec3  position = light.position.xyz, direction = light.direction.xyz;
 
-	float angle = 0.0, intensity = 1.0;
+	bool isSpotlight   = (innerCone != 0.0 && outerCone != 0.0 && direction != vec3(0.0, 0.0, 0.0));
+	bool isDirectional = (direction != vec3(0.0, 0.0, 0.0) && !isSpotlight);
 
-	// Compute the light vector (point light only).
-	vec3 lightVec = light.position == vec3(0, 0, 0) ? vec3(0, 0, 0) : light.position - fragPos;
+	// Compute the light vector (point and spot lights only).
+	vec3  lightVec = position - fragPos;
+	float lightDistance = length(lightVec);
 
 	// Diffuse calculation.
-	vec3  normal   = normalize(normal);
-	vec3  lightDir = normalize(isDirectional ? -light.direction : lightVec);
+	vec3  lightDir = isDirectional ? normalize(-direction) : lightVec / max(lightDistance, 1e-4);
 	float diff     = max(dot(normal, lightDir), 0.0);
 
 	// Specular calculation.
-	vec3  viewDir    = normalize(viewPos - fragPos);
 	vec3  halfwayVec = normalize(viewDir + lightDir);
 	float spec       = pow(max(dot(normal, halfwayVec), 0), 32.0);
 
 	// Light intensity calculation (directional light intensity is 1.0 by default).
-	if (isSpotlight)
+	float intensity = 1.0;
+	if (!isDirectional)
 	{
-		angle 	  = dot(vec3(0, -1, 0), -lightDir);
-		intensity = clamp((angle - light.outerCone) / (light.innerCone - light.outerCone), 0.0, 1.0);
+		intensity = 1.0 / (1.0 + linear * lightDistance + quadratic * lightDistance * lightDistance);
+
+		// Fade to zero at the light range, past which it is not assigned to clusters.
+		if (range > 0.0)
+		{
+			float falloff = clamp(1.0 - pow(lightDistance / range, 4.0), 0.0, 1.0);
+			intensity *= falloff * falloff;
+		}
 	}
-	else if (!isDirectional)
+	if (isSpotlight)
 	{
-		intensity = 1.0 / (1 + light.linear * light.range + light.quadratic * pow(light.range, 2.0));
+		float angle = dot(normalize(direction), -lightDir);
+		intensity *= clamp((angle - outerCone) / (innerCone - outerCone), 0.0, 1.0);
 	}
 
-	vec4 ambient  = texture(tex, texCoord) * vec4(light.ambient, 1);
-	vec4 diffuse  = texture(tex, texCoord) * diff * intensity;
-	vec4 specular = texture(tex, texCoord) * spec * intensity;
-
-	return ambient + diffuse + specular;
+	return light.ambient.xyz + (light.diffuse.xyz * diff + light.specular.xyz * spec) * intensity;
 }
 
 void main()
 {
-	// Sum all computed lights to the current pixel.
-    vec4 result = vec4(0,0,0,0);
-	for (int i = 0; i < MAX_LIGHTS; i++)
-        result += computeLight(lights[i]);
+	vec3 normal  = normalize(normal);
+	vec3 viewDir = normalize(cameraPos.xyz - fragPos);
+
+	// Sum the lights of the current cluster only.
+	uvec2 range  = clusterRanges[computeCluster()];
+	vec3  result = vec3(0, 0, 0);
+	for (uint i = 0; i < range.y; i++)
+		result += computeLight(lights[clusterLights[range.x + i]], normal, viewDir);
 
-	fragColor = result;
+	fragColor = texture(tex, texCoord) * vec4(result, 1);
 }
\ No newline at end of file
@@ -0,0 +1,20 @@
+#version 450 core
+
+// G-buffer outputs.
+layout (location = 0) out vec4 gAlbedo;
+layout (location = 1) out vec4 gNormal; // xyz: world normal packed to [0, 1].
+
+// Shader inputs.
+in vec3 fragPos;
+in vec2 texCoord;
+in vec3 normal;
+
+// Texture maps related.
+uniform sampler2D tex;
+
+void main()
+{
+	// Lighting is deferred to the tiled lighting pass.
+	gAlbedo = texture(tex, texCoord);
+	gNormal = vec4(normalize(normal) * 0.5 + 0.5, 0);
+}
\ No newline at end of file
@@ -3,24 +3,45 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec2 aTex;
 layout (location = 2) in vec3 aNormal;
+layout (location = 3) in uint aInstance; // Per-instance, offset by the draw base instance.
 
 // Shader outputs.
 out vec3 fragPos;
 out vec2 texCoord;
 out vec3 normal;
 
-uniform mat4 mvp;
-uniform mat4 model;
+// Depth pre-pass positions must match exactly.
+invariant gl_Position;
+
+// Frame related (std140 layout of Renderer::FrameConstantsData).
+layout (std140, binding = 0) uniform FrameConstants
+{
+	mat4 view;
+	mat4 projection;
+	mat4 viewProj;
+	vec4 cameraPos;
+	vec4 time;     // x: time, y: delta time.
+	vec4 viewport; // xy: size, zw: inverse size.
+	vec4 clusters; // x: near, y: far, z: depth slice scale, w: depth slice bias.
+};
+
+// Instances related (std430 layout of Renderer::InstanceData).
+layout (std430, binding = 2) readonly buffer Instances
+{
+	mat4 models[];
+};
 
 
 void main()
 {
 	// Compute current position.
-	fragPos = vec3(model * vec4(aPos, 1.0f));
+	mat4 model    = models[aInstance];
+	vec4 worldPos = model * vec4(aPos, 1.0f);
+	fragPos  = vec3(worldPos);
 	texCoord = aTex;
 	normal   = normalize(model * vec4(aNormal, 0.0)).xyz;
 
 	// Outputs the positions/coordinates of all vertices.
-	gl_Position = mvp * vec4(aPos, 1.0);
+	gl_Position = viewProj * worldPos;
 
 }
\ No newline at end of file
@@ -4,27 +4,32 @@
 #include <GLFW/glfw3.h>
 
 #include <string>
+#include <vector>
 
 #include <Camera.h>
+#include <Headless.h>
+#include <CameraRecording.h>
+#include <Benchmark.h>
+#include <FramePacer.h>
 #include <ResourceManager.h>
+#include <FrameQueue.h>
 #include <UserInterface.h>
 
 namespace Core
 {
-	static float frameAspectRatio; // Requiered for dynamic window / frame buffer resizing callback.
-
 	class App
 	{
 	public:
 		// Constructors.
-		App(unsigned int glVersionMajor, unsigned int glVersionMinor, bool fullScreen = true);
+		App(unsigned int glVersionMajor, unsigned int glVersionMinor, bool fullScreen = true, bool renderThread = true,
+			const HeadlessSettings& headless = HeadlessSettings());
 		~App();
 
 		// Public main methods.
 		void Init();		// Init sequence of the application.
 		void Run();			// Aplication run.
-		void EarlyUpdate(); // Application update before rendering.
-		void Render();      // Application rendering.
+		bool EarlyUpdate(); // Application update before rendering, false when no frame snapshot was published.
+		bool Render();      // Application rendering of the next snapshot, false once the queue is closed.
 		void LateUpdate();  // Application update after rendering.
 		void Unload();      // Unload all ressources.
 
@@ -35,21 +40,44 @@ namespace Core
 
 		// Private others members.
 		bool m_fullScreen, m_windowFocused, m_sceneFocused;
+		bool m_renderThread; // Render snapshots on a dedicated thread owning the GL context.
+
+		// Headless runs render in an offscreen target of an invisible window.
+		HeadlessSettings m_headless;
+		GLuint m_offscreenFramebuffer, m_offscreenColor, m_offscreenDepth;
+
+		// Camera recorded from the user interface, and the recording replayed by benchmarks.
+		CameraRecording m_recording, m_replay;
+		size_t m_replayFrame;
+		double m_sampleTime;
+		std::vector<Debug::FrameSample> m_samples;
+		unsigned long long m_snapshotFrame; // Last published, the samples are recorded for it.
 
 		int m_screenWidth, m_screenHeight;
 		unsigned int m_glVersionMajor, m_glVersionMinor;
 		unsigned int VBO, VAO, EBO;
 
 		float m_deltaTime, m_lastFrame;
+		bool  m_frameSkipped; // Last on-demand frame had nothing to render.
 		double m_mouseX, m_mouseY;
 
+		// Render thread results of the frame being presented, handed to the main thread with its slot.
+		Renderer::RenderStats m_frameResults;
+
 		// Extern private members.
 		Renderer::Camera m_camera;
 
 		// Private initialiazers.
 		void InitGLContext();
+		void InitWindow();    // GLFW window owning the context, invisible for native headless runs.
 		void InitShaders();
 		void InitSampler();
+		void InitOffscreen();
+
+		// Private runners.
+		void RunHeadless(); // Fixed timestep frames, then prints the frame time statistics.
+		void RecordSample(const float& cpuMs);
+		void ReportBenchmark(const std::string& name); // Waits for the frames in flight first.
 
 		// Private loaders.
 		void LoadScene();
@@ -57,11 +85,11 @@ namespace Core
 		// Private updaters.
 		void UpdateInputs(GLFWwindow* window, double* mouseX, double* mouseY, Renderer::CameraInputs* inputs);
 		void UpdateCursor(GLFWwindow* window, double  mouseX, double  mouseY, Renderer::CameraInputs* inputs);
-		void UpdateWindow(GLFWwindow* window);
+		void UpdateFrameResults(const unsigned long long& frame); // Render thread: gather the stats and profiler results of the frame.
+		void UpdateSamples(const std::vector<Renderer::FrameDrawCounts>& draws, const std::vector<Renderer::GpuFrameTime>& gpuTimes);
 	};
 
 }
 
 // GL functions and callbacks.
 void processInput(GLFWwindow* window, Renderer::CameraInputs* inputs, const bool& sceneFocused);
-void framebuffer_size_callback(GLFWwindow* window, int width, int height);
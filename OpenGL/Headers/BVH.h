@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vector>
+
+#include <Bounds.h>
+#include <FrustumCuller.h>
+
+#define BVH_NULL_NODE  -1
+#define BVH_FAT_MARGIN 0.1f // Leaves boxes are enlarged by this fraction of their size to absorb small moves.
+#define BVH_SAH_BINS   16
+#define BVH_PARALLEL_LEAVES   1024 // Smaller trees are culled by the calling thread only.
+#define BVH_PARALLEL_SUBTREES 32   // Subtrees culled as separate jobs.
+
+namespace Core::Scene
+{
+	// Tree node, leaves hold a user pointer and their fattened box.
+	struct BVHNode
+	{
+		float min[3], max[3];
+		int parent, left, right; // Leaves have no children.
+		int height;              // 0 for leaves.
+		void* userData;
+
+		bool IsLeaf() const { return left == BVH_NULL_NODE; }
+	};
+
+	// Leaf copied contiguously for the top-down build.
+	struct BVHBuildItem
+	{
+		float min[3], max[3], centroid[3];
+		int leaf;
+	};
+
+	// Dynamic bounding volume hierarchy: SAH bulk build, incremental insertions refitted with tree rotations.
+	class BVH
+	{
+	public:
+		int  Insert(const Core::Maths::Bounds& bounds, void* userData);
+		void Remove(const int& proxy);
+		bool Move  (const int& proxy, const Core::Maths::Bounds& bounds); // Returns whether the leaf was reinserted.
+		void Rebuild(); // Rebuild the whole tree top-down with the surface area heuristic.
+		void Clear();
+
+		// Append user pointers of leaves intersecting the frustum, subtrees fully inside are accepted without tests.
+		Renderer::CullingStats Cull(const Renderer::Frustum& frustum, std::vector<void*>& visible) const;
+
+		int GetHeight()    const;
+		int GetLeafCount() const;
+		const BVHNode& GetNode(const int& index) const;
+
+	private:
+		std::vector<BVHNode> m_nodes;
+		int m_root     = BVH_NULL_NODE;
+		int m_freeList = BVH_NULL_NODE; // Free nodes are chained through their parent index.
+		int m_leafCount = 0;
+
+		int  AllocateNode();
+		void FreeNode(const int& index);
+		void InsertLeaf(const int& leaf);
+		void RemoveLeaf(const int& leaf);
+		void Refit(int index);
+		void Rotate(const int& index);
+		int  BuildRange(std::vector<BVHBuildItem>& items, const int& begin, const int& end);
+		void AppendLeaves(const int& index, std::vector<void*>& out) const;
+		void CullSubtree(const int& root, const Renderer::Frustum& frustum, std::vector<void*>& visible, unsigned int& tested) const;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace Core::Debug
+{
+	struct FrameSample
+	{
+		unsigned long long frame; // Snapshot index, the render results are matched by it.
+		float cpuMs;
+		float gpuMs; // Negative until the profiler reads the frame back.
+		unsigned int multiDraws, triangles;
+	};
+
+	// Milliseconds over all frames of a run, percentiles by nearest rank.
+	struct FrameTimeStats
+	{
+		float average, p50, p95, p99, best, worst;
+
+		static FrameTimeStats Compute(std::vector<float> times);
+	};
+
+	// Frame statistics of headless runs and camera replays.
+	class Benchmark
+	{
+	public:
+		static void Report(const std::string& name, const std::vector<FrameSample>& samples);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <Vector3.h>
+#include <Matrix.h>
+
+namespace Core::Maths
+{
+	// Axis-aligned box and bounding sphere sharing the same center.
+	struct Bounds
+	{
+		Core::Maths::Vector3 center;  // Box and sphere center.
+		Core::Maths::Vector3 extents; // Box half size on each axis.
+		float radius = 0;             // Sphere radius.
+
+		// Bounds of the points after transformation by the given (row vector) matrix.
+		Bounds GetTransformed(const Core::Maths::Matrix4& mat) const;
+	};
+}
\ No newline at end of file
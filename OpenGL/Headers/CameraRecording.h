@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <Vector3.h>
+#include <Camera.h>
+
+#define CAMERA_RECORDING_MAGIC   0x43455243 // "CREC".
+#define CAMERA_RECORDING_VERSION 1
+#define CAMERA_RECORDING_PATH    "camera.rec"
+#define CAMERA_RECORDING_FRAME   29 // Bytes per frame on disk.
+
+namespace Core
+{
+	// Camera state and inputs of one frame, CAMERA_RECORDING_FRAME bytes on disk.
+	struct CameraFrame
+	{
+		Core::Maths::Vector3 position;
+		float   pitch, yaw;
+		float   deltaX, deltaY; // Mouse movement.
+		uint8_t keys;           // Backward, forward, right, left, up and down bits.
+	};
+
+	// Camera recorded once per frame, replayed frame by frame at a fixed timestep whatever the recording frame rate.
+	class CameraRecording
+	{
+	public:
+		static bool recording; // Toggled by the user interface, the recording is saved when it stops.
+
+		void Add(const Renderer::Camera& camera);
+		void Apply(const size_t& frame, Renderer::Camera& camera) const;
+		void Clear();
+
+		bool Save(const std::string& path) const;
+		bool Load(const std::string& path);
+
+		size_t GetFrameCount() const;
+
+	private:
+		std::vector<CameraFrame> m_frames;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <chrono>
+
+namespace Core
+{
+	// Seconds since the first call. Unlike glfwGetTime, it does not need GLFW: headless EGL and OSMesa runs never initialize it.
+	inline double GetTime()
+	{
+		static const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - origin).count();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <vector>
+
+#define COMMAND_ALIGNMENT    8  // Packets start on 8 bytes boundaries.
+#define COMMAND_RECORD_CHUNK 64 // Batches recorded by each worker task.
+
+namespace Renderer
+{
+	enum class CommandType : uint16_t
+	{
+		BindProgram,
+		BindVertexArray,
+		BindVertexBuffer,
+		BindBufferRange,
+		BindIndirectBuffer,
+		BindTexture,
+		BindSampler,
+		DrawIndirect, // Indexed triangles multi-draw.
+		Count
+	};
+
+	// Every packet starts with its type and size, so that a buffer is walked without knowing each layout.
+	struct CommandHeader
+	{
+		CommandType type;
+		uint16_t    size; // Bytes, header and padding included.
+	};
+
+	struct BindProgramCommand        { CommandHeader header; GLuint program; };
+	struct BindVertexArrayCommand    { CommandHeader header; GLuint vertexArray; };
+	struct BindVertexBufferCommand   { CommandHeader header; GLuint vertexArray, index, buffer, stride; GLintptr offset; };
+	struct BindBufferRangeCommand    { CommandHeader header; GLenum target; GLuint index, buffer; GLintptr offset; GLsizeiptr size; };
+	struct BindIndirectBufferCommand { CommandHeader header; GLuint buffer; };
+	struct BindTextureCommand        { CommandHeader header; GLuint unit, texture; };
+	struct BindSamplerCommand        { CommandHeader header; GLuint unit, sampler; };
+	struct DrawIndirectCommand       { CommandHeader header; GLsizei drawCount; GLintptr offset; };
+
+	// Replay counters of a frame, accumulated over every executed buffer.
+	struct CommandStats
+	{
+		unsigned int counts[(size_t)CommandType::Count];
+		unsigned int packets;
+		unsigned int buffers; // Recorded buffers merged in the replayed ones.
+		size_t       bytes;
+		bool         valid;   // Last validation result.
+	};
+
+	// Linearly allocated stream of GL command packets, recorded on any thread and replayed on the GL one.
+	// The storage is kept between frames, reset only rewinds the allocation head.
+	class CommandBuffer
+	{
+	public:
+		void Reset();
+		void Append(const CommandBuffer& other); // Merge the packets of another buffer after these ones.
+
+		void BindProgram       (const GLuint& program);
+		void BindVertexArray   (const GLuint& vertexArray);
+		void BindVertexBuffer  (const GLuint& vertexArray, const GLuint& index, const GLuint& buffer, const GLintptr& offset, const GLuint& stride);
+		void BindBufferRange   (const GLenum& target, const GLuint& index, const GLuint& buffer, const GLintptr& offset, const GLsizeiptr& size);
+		void BindIndirectBuffer(const GLuint& buffer);
+		void BindTexture       (const GLuint& unit, const GLuint& texture);
+		void BindSampler       (const GLuint& unit, const GLuint& sampler);
+		void DrawIndirect      (const GLintptr& offset, const GLsizei& drawCount);
+
+		bool Validate() const;                  // Check packets layout and draw states, the first error is logged.
+		void Execute(CommandStats& stats) const; // Replay against GL, in recording order.
+
+		size_t GetSize() const { return m_size; }
+		static const char* GetTypeName(const CommandType& type);
+
+	private:
+		std::vector<uint8_t> m_data;
+		size_t m_size = 0; // Allocation head.
+
+		template<typename T> T* Push(const CommandType& type);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,113 @@
+#pragma once
+
+// Defined by the project configurations, zones compile to nothing without it.
+#ifdef ENABLE_PROFILER
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#define CPU_PROFILER_EVENTS     65536 // Power of two, zones kept per thread, older ones are overwritten.
+#define CPU_PROFILER_TRACE_PATH "cpu_trace.json"
+
+#define PROFILER_CONCAT_INNER(a, b) a##b
+#define PROFILER_CONCAT(a, b)       PROFILER_CONCAT_INNER(a, b)
+
+// Times the enclosing scope, the name must be a string literal.
+#define PROFILE_ZONE(name)                                                                                                     \
+	static const Core::Debug::ProfileSource PROFILER_CONCAT(profileSource, __LINE__) = { name, __FUNCTION__, __FILE__, __LINE__ }; \
+	Core::Debug::ProfileScope PROFILER_CONCAT(profileScope, __LINE__)(&PROFILER_CONCAT(profileSource, __LINE__))
+#define PROFILE_FUNCTION()   PROFILE_ZONE(__FUNCTION__)
+#define PROFILE_THREAD(name) Core::Debug::CpuProfiler::SetThreadName(name)
+
+namespace Core::Debug
+{
+	// Static source location of a zone, events only keep a pointer to it.
+	struct ProfileSource
+	{
+		const char*  name;
+		const char*  function;
+		const char*  file;
+		unsigned int line;
+	};
+
+	struct ProfileEvent
+	{
+		const ProfileSource* source;
+		uint64_t begin, end; // Ticks.
+	};
+
+	// Relaxed atomics, plain stores on x86, so that the export can copy a slot being overwritten.
+	struct ProfileSlot
+	{
+		std::atomic<const ProfileSource*> source;
+		std::atomic<uint64_t> begin, end;
+	};
+
+	// Ring of the zones closed by one thread, written by its owner only.
+	struct ProfileThreadBuffer
+	{
+		ProfileSlot           events[CPU_PROFILER_EVENTS];
+		std::atomic<uint64_t> written = 0; // Published after the event, read by the export.
+		ProfileThreadBuffer*  next    = nullptr;
+		unsigned int          id      = 0;
+		char                  name[32] = {};
+	};
+
+	// Scoped CPU zones recorded in per-thread buffers without locks, exported as Chrome trace events
+	// (chrome://tracing, Perfetto) on demand.
+	class CpuProfiler
+	{
+	public:
+		static bool exportRequested; // Set from the user interface, handled by the main thread.
+
+		static void SetThreadName(const std::string& name);
+		static void Record(const ProfileSource* source, const uint64_t& begin, const uint64_t& end);
+		static bool ExportTrace(const std::string& path); // Any thread, zones closed meanwhile may be missing.
+		static void Unload(); // Once every other recording thread is joined.
+
+		static uint64_t Now()
+		{
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+			return __rdtsc();
+#else
+			return (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+		}
+
+	private:
+		static std::atomic<ProfileThreadBuffer*> buffers; // Lock-free list, threads push their buffer once.
+		static std::atomic<unsigned int> threadCount;
+		static thread_local ProfileThreadBuffer* threadBuffer;
+
+		static ProfileThreadBuffer* GetThreadBuffer();
+		static ProfileThreadBuffer* Register(const std::string& name);
+		static double GetTicksPerMicrosecond();
+	};
+
+	class ProfileScope
+	{
+	public:
+		ProfileScope(const ProfileSource* source) : m_source(source), m_begin(CpuProfiler::Now()) { }
+		~ProfileScope() { CpuProfiler::Record(m_source, m_begin, CpuProfiler::Now()); }
+
+	private:
+		const ProfileSource* m_source;
+		uint64_t m_begin;
+	};
+}
+
+#else
+
+#define PROFILE_ZONE(name)
+#define PROFILE_FUNCTION()
+#define PROFILE_THREAD(name)
+
+#endif
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <Camera.h>
+
+namespace Core::Debug
+{
+	// Compares flat and hierarchical frustum culling on synthetic scenes of growing size.
+	class CullingBenchmark
+	{
+	public:
+		static bool requested; // Set by the user interface, run by the application before the next frame.
+
+		static void Run(const Renderer::Camera& camera);
+
+	private:
+		static void RunScene(const Renderer::Camera& camera, const unsigned int& count);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <Camera.h>
+
+#define FRAME_CONSTANTS_BINDING 0 // Uniform buffer binding of the frame constants.
+
+namespace Renderer
+{
+	// Frame constants std140 layout, mirrored by the shaders FrameConstants block.
+	struct FrameConstantsData
+	{
+		float view[16];
+		float projection[16];
+		float viewProj[16];
+		float cameraPos[4]; // w: unused.
+		float time[4];      // x: time, y: delta time.
+		float viewport[4];  // xy: size, zw: inverse size.
+		float clusters[4];  // x: near, y: far, z: depth slice scale, w: depth slice bias.
+	};
+
+	class FrameConstants
+	{
+	public:
+		static FrameConstantsData data;
+
+		static void Update(const Camera& camera, const float& time, const float& deltaTime, const int& width, const int& height);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <GLFW/glfw3.h>
+
+#define FRAME_PACER_IDLE_TIMEOUT 0.5 // Seconds an idle on-demand frame waits for events before checking for changes again.
+#define FRAME_PACER_SETTLE       3   // Frames rendered after the last change, for interface hover states and queued snapshots.
+
+namespace Core
+{
+	enum class SwapMode { Immediate, VSync, HalfRate, Adaptive };
+
+	// Edited from the user interface, the swap interval is copied in each frame snapshot.
+	struct FramePacingSettings
+	{
+		SwapMode swapMode;
+		float    frameLimit; // Frames per second, 0 for none.
+		bool     onDemand;   // Only render frames when something changed.
+	};
+
+	struct FramePacingStats
+	{
+		unsigned int rendered, skipped; // On-demand frames.
+		float limiterErrorMs;           // Moving average of the frame start distance to its deadline.
+		float sleepEstimateMs;          // Expected duration of a 1 ms sleep, spun instead near the deadline.
+	};
+
+	// Main loop pacing: frame rate limiter, on-demand rendering and swap interval.
+	class FramePacer
+	{
+	public:
+		static FramePacingSettings settings;
+		static FramePacingStats    stats;
+
+		static void Init(GLFWwindow* window); // With the context current, before the user interface chains the input callbacks.
+		static void Limit();                  // Main thread: sleep then spin until the next frame deadline.
+		static void WaitEvents(const bool& continuous); // Poll, or wait for events while on-demand frames are idle.
+		static bool ShouldRender(const bool& changed);  // False when an on-demand frame can be skipped.
+		static void RequestRedraw();
+
+		static int  GetSwapInterval();
+		static void ApplySwapInterval(const int& interval); // Context thread, only calls GLFW on changes.
+
+	private:
+		static bool         tearSupported; // Adaptive vsync swap interval of -1.
+		static int          appliedInterval;
+		static unsigned int redrawFrames;
+		static double       deadline;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+#include <condition_variable>
+
+#include <Camera.h>
+#include <ModelManager.h>
+#include <LightManager.h>
+#include <SceneRenderer.h>
+#include <ResolutionScaler.h>
+#include <FrameRing.h>
+#include <GLState.h>
+#include <GpuProfiler.h>
+#include <UserInterface.h>
+
+#define FRAME_QUEUE_DEPTH 2 // Snapshots in flight: one rendered while the next one is built.
+
+namespace Renderer
+{
+	// Immutable copy of everything a frame renders, built by the main thread and read by the render thread only.
+	struct SceneSnapshot
+	{
+		unsigned long long frame;
+		double inputTime;   // Inputs polling, start of the input to present latency.
+		double publishTime;
+		double renderTime;  // Picked up by the render thread.
+
+		Camera camera;
+		float  time, deltaTime;
+		int    width, height;
+
+		RenderPath   path;
+		bool         depthPrepass;
+		ResolutionSettings resolution;
+		int          swapInterval;
+		DrawSnapshot  draws;
+		LightSnapshot lights;
+		Core::UI::UIDrawData ui;
+	};
+
+	// Exponential moving averages in milliseconds, updated as frames are presented.
+	struct FrameLatencyStats
+	{
+		float inputToPresent;
+		float queued;         // Published to picked up by the render thread.
+		float render;         // Render thread time spent on a frame, swap included.
+		float mainWait;       // Main thread blocked by a full queue.
+		float renderWait;     // Render thread starved of snapshots.
+		unsigned int depth;   // Snapshots published and not presented yet.
+	};
+
+	// Draws of a frame for benchmarks, indexed like SceneSnapshot::frame.
+	struct FrameDrawCounts
+	{
+		unsigned long long frame;
+		unsigned int multiDraws, triangles;
+	};
+
+	// Results of a presented frame, handed back by the render thread so that the main thread never reads its state.
+	struct RenderStats
+	{
+		FrameLatencyStats latency;
+		RenderQueueStats  draws;
+		CommandStats      commands;
+		GLStateStats      glState;
+		FrameRingStats    frameRing;
+		RenderPath        path; // Rendered, forward when the deferred targets are not supported.
+		bool              deferredFailed;
+		RenderPassTimings timings;
+		float             resolutionScale;
+		int               sceneWidth, sceneHeight;
+		std::vector<GpuZoneResult>  gpuZones;
+		std::vector<GpuZoneHistory> gpuHistory;
+		unsigned int      gpuHistoryFrame;
+		unsigned int      gpuDroppedFrames;
+		std::vector<FrameDrawCounts> frameDraws;    // Appended by each release until copied, so no frame is missed.
+		std::vector<GpuFrameTime>    gpuFrameTimes; // Likewise, as the profiler reads frames back.
+	};
+
+	// Bounded single producer / single consumer queue of scene snapshots between the main and render threads.
+	class FrameQueue
+	{
+	public:
+		static RenderStats renderStats; // Main thread copy of the last presented frame results.
+
+		static SceneSnapshot* Acquire(); // Main thread: slot to fill, waits while FRAME_QUEUE_DEPTH frames are in flight.
+		static void Publish(SceneSnapshot* snapshot);
+		static SceneSnapshot* Pop();     // Render thread: oldest published snapshot, nullptr once closed and drained.
+		static void Release(SceneSnapshot* snapshot, const double& presentTime, const RenderStats& frameResults);
+		static void CopyRenderStats();   // Main thread: update renderStats from the last released frame.
+		static void Close();
+		static void Unload();            // Free the draw lists still held by the slots.
+
+	private:
+		static FrameLatencyStats stats;
+		static RenderStats results; // Of the last released frame.
+		static SceneSnapshot slots[FRAME_QUEUE_DEPTH];
+		static unsigned long long published, popped, released;
+		static bool closed;
+		static std::mutex queueMutex;
+		static std::condition_variable freed, ready;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <vector>
+
+#define FRAME_RING_REGIONS     3         // Frames the CPU may write ahead of the GPU.
+#define FRAME_RING_REGION_SIZE (4 << 20) // Initial bytes per frame region, grown on overflow.
+
+namespace Renderer
+{
+	// Sub-allocation of the frame ring, written through its persistently mapped pointer.
+	struct RingAllocation
+	{
+		GLuint   buffer;
+		GLintptr offset;
+		size_t   size;
+		void*    data;
+	};
+
+	struct FrameRingStats
+	{
+		size_t       used;        // Bytes allocated by the last frame.
+		size_t       regionSize;
+		unsigned int fenceWaits;  // Frames which had to wait for the GPU to release their region.
+		unsigned int overflows;   // Allocations served by a temporary buffer.
+	};
+
+	// Per-frame dynamic data ring: a persistent, coherent mapped buffer split in FRAME_RING_REGIONS regions,
+	// each guarded by a fence so that the CPU never overwrites data the GPU still reads.
+	class FrameRing
+	{
+	public:
+		static FrameRingStats stats; // Render thread, read through FrameQueue::renderStats.
+
+		static void Init();
+		static void BeginFrame(); // Wait for the GPU to release the next region.
+		static void EndFrame();   // Fence the commands of this frame region.
+		static void Unload();
+
+		static RingAllocation Allocate(const size_t& size, const size_t& alignment);
+		static RingAllocation AllocateUniform(const size_t& size);
+		static RingAllocation AllocateStorage(const size_t& size);
+
+	private:
+		static GLuint   buffer;
+		static uint8_t* mapped;
+		static GLsync   fences[FRAME_RING_REGIONS];
+		static std::vector<GLuint> overflowBuffers[FRAME_RING_REGIONS];
+		static unsigned int region;
+		static size_t   regionSize, head, requiredSize;
+		static GLint    uniformAlignment, storageAlignment;
+
+		static void CreateBuffer();
+		static void WaitRegion(const unsigned int& region);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <Matrix.h>
+#include <Bounds.h>
+
+// Bounds tested per SIMD iteration.
+#ifdef __AVX__
+	#define CULL_BATCH_SIZE 8
+#else
+	#define CULL_BATCH_SIZE 4
+#endif
+
+namespace Renderer
+{
+	// Normalized clip planes (xyz normal pointing inside, w distance).
+	struct Frustum
+	{
+		float planes[6][4];
+
+		// Extract the planes of a row vector view projection matrix.
+		static Frustum FromMatrix(const Core::Maths::Matrix4& viewProj);
+	};
+
+	// Culling counters of the last frame.
+	struct CullingStats
+	{
+		unsigned int visible;
+		unsigned int culled;
+		unsigned int tested; // Bounds tested against the planes.
+	};
+
+	// Tests boxes against a frustum, stored structure of arrays to test several boxes at once.
+	class FrustumCuller
+	{
+	public:
+		void Clear();
+		void Push(const Core::Maths::Bounds& bounds);
+		CullingStats Cull(const Frustum& frustum);
+
+		bool   IsVisible(const size_t& index) const;
+		size_t GetCount() const;
+
+	private:
+		size_t m_count = 0;
+		std::vector<float> m_centerX,  m_centerY,  m_centerZ;
+		std::vector<float> m_extentsX, m_extentsY, m_extentsZ;
+		std::vector<uint8_t> m_visible;
+	};
+}
\ No newline at end of file
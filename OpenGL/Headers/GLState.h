@@ -0,0 +1,64 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <unordered_map>
+
+#define GL_STATE_UNKNOWN         0xFFFFFFFF // Shadowed value not known, the next call is always issued.
+#define GL_STATE_TEXTURE_UNITS   32         // Texture and sampler units shadowed, higher units are always bound.
+#define GL_STATE_BUFFER_BINDINGS 16         // Indexed uniform and storage buffer bindings shadowed.
+
+namespace Renderer
+{
+	enum class GLStateCall { Program, VertexArray, Texture, Sampler, Buffer, Enable, Count };
+
+	// Calls of the last frame by kind, the skipped ones would not have changed the context state.
+	struct GLStateStats
+	{
+		unsigned int issued [(size_t)GLStateCall::Count];
+		unsigned int skipped[(size_t)GLStateCall::Count];
+	};
+
+	// Shadow of the context bindings and capabilities, only used by the thread owning the context.
+	// State changed without it must be invalidated, the interface backend restores everything it binds.
+	class GLState
+	{
+	public:
+		static GLStateStats stats; // Read through FrameQueue::renderStats.
+
+		static void BeginFrame(); // Publish the counters of the last frame.
+		static void Invalidate(); // Forget the whole state, e.g. once objects are deleted: their names may be reused.
+
+		static void UseProgram     (const GLuint& program);
+		static void BindVertexArray(const GLuint& vertexArray);
+		static void BindTextureUnit(const GLuint& unit, const GLuint& texture);
+		static void BindSampler    (const GLuint& unit, const GLuint& sampler);
+		static void BindBuffer     (const GLenum& target, const GLuint& buffer); // Indirect draw and parameter buffers.
+		static void BindBufferBase (const GLenum& target, const GLuint& index, const GLuint& buffer);
+		static void BindBufferRange(const GLenum& target, const GLuint& index, const GLuint& buffer, const GLintptr& offset, const GLsizeiptr& size);
+		static void Enable         (const GLenum& capability);
+		static void Disable        (const GLenum& capability);
+
+		static const char* GetCallName(const GLStateCall& call);
+
+	private:
+		struct BufferBinding
+		{
+			GLuint     buffer;
+			GLintptr   offset;
+			GLsizeiptr size; // -1 for the whole buffer.
+		};
+
+		static GLuint        program, vertexArray;
+		static GLuint        textures[GL_STATE_TEXTURE_UNITS], samplers[GL_STATE_TEXTURE_UNITS];
+		static GLuint        indirectBuffer, parameterBuffer;
+		static BufferBinding uniformBuffers[GL_STATE_BUFFER_BINDINGS], storageBuffers[GL_STATE_BUFFER_BINDINGS];
+		static std::unordered_map<GLenum, bool> capabilities;
+		static GLStateStats  frame; // Counters of the current frame.
+
+		static bool Update(GLuint& shadow, const GLuint& value, const GLStateCall& call); // True when the call must be issued.
+		static bool UpdateIndexed(const GLenum& target, const GLuint& index, const BufferBinding& binding);
+		static void Count(const bool& issued, const GLStateCall& call);
+	};
+}
\ No newline at end of file
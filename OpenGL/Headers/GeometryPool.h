@@ -0,0 +1,40 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <vector>
+
+#include <Vertex.h>
+
+#define INSTANCE_BUFFER_INDEX 1 // Vertex buffer binding of the per-instance attributes.
+
+namespace Resources
+{
+	// Location of a mesh inside the geometry pool buffers.
+	struct GeometryRange
+	{
+		unsigned int baseVertex, firstIndex, indexCount;
+		unsigned int index; // Order in which the mesh was added to the pool.
+	};
+
+	// Vertices and indices of all meshes, sub-allocated in shared buffers behind a single VAO.
+	// Positions are also split in their own stream, read by depth only passes through depthVAO.
+	class GeometryPool
+	{
+	public:
+		static GLuint VAO, VBO, EBO;
+		static GLuint depthVAO, positionBuffer;
+
+		static GeometryRange Add(const std::vector<Core::Maths::Vertex>& vertices, const std::vector<uint32_t>& indices);
+		static void Unload();
+
+	private:
+		static unsigned int vertexCount, vertexCapacity;
+		static unsigned int indexCount,  indexCapacity;
+		static unsigned int meshCount;
+
+		static void Init();
+		static void Grow(GLuint& buffer, const size_t& usedSize, const size_t& newSize);
+	};
+}
\ No newline at end of file
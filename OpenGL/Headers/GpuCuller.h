@@ -0,0 +1,69 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include <Matrix.h>
+#include <Model.h>
+#include <ModelManager.h>
+
+// Shader storage bindings of the GPU culling buffers (transforms use INSTANCES_BINDING).
+#define GPU_OBJECTS_BINDING  3
+#define GPU_COMMANDS_BINDING 4
+#define GPU_VISIBLE_BINDING  5
+#define GPU_GROUPS_BINDING   6
+#define GPU_COMPACT_BINDING  7
+#define GPU_COUNTS_BINDING   8
+#define GPU_HIZ_UNIT         3 // Texture unit of the depth pyramid.
+
+namespace Renderer
+{
+	// Per-object std430 layout, mirrored by the culling shader Objects buffer.
+	struct GpuObjectData
+	{
+		float center[4];
+		float extents[4];
+		unsigned int group[4]; // x: draw group.
+	};
+
+	// Consecutive draw groups sharing a texture, drawn with one multi-draw.
+	struct GpuDrawRun
+	{
+		GLuint texture;
+		unsigned int firstGroup, groupCount;
+	};
+
+	// Culls and builds indirect draws on the GPU, the CPU cost only depends on the textures count.
+	class GpuCuller
+	{
+	public:
+		static bool hiZCulling;    // Also cull against last frame depth, objects revealed by camera motion appear one frame late. Copied in each snapshot.
+		static bool indirectCount; // Driver supports ARB_indirect_parameters.
+		static unsigned int objectCount, groupCount;
+		static std::vector<GpuDrawRun> runs;
+
+		static void Init();
+		static void Build(const std::vector<GpuSceneObject>& objects);
+		static void UpdateTransforms(const std::vector<std::pair<Core::Scene::SceneNode*, InstanceData>>& moved);
+		static void Cull(const bool& hiZ); // Visible instances and draw commands, read by the next draws.
+		static void Draw(const GLuint& program, const GLuint& sampler);
+		static void DrawDepth(const GLuint& depthProgram);
+		static void Unload();
+
+	private:
+		static GLuint cullProgram, compactProgram, hiZProgram;
+		static GLuint transformBuffer, objectBuffer, templateBuffer, commandBuffer;
+		static GLuint visibleBuffer, groupBuffer, compactBuffer, countBuffer;
+		static GLuint depthTexture, depthFramebuffer, hiZTexture;
+		static int depthWidth, depthHeight;
+		static bool hiZEnabled; // Setting of the snapshot being drawn.
+		static Core::Maths::Matrix4 hiZViewProj; // View projection of the frame the pyramid was built from.
+		static std::unordered_map<Core::Scene::SceneNode*, unsigned int> objectIndices;
+
+		static void BuildHiZ();
+		static void DeleteBuffers();
+	};
+}
\ No newline at end of file
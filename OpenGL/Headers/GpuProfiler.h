@@ -0,0 +1,87 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <string>
+#include <vector>
+
+#define GPU_PROFILER_LATENCY   4    // Frames between a zone and its read back, so that reading never stalls.
+#define GPU_PROFILER_MAX_ZONES 32   // Timed zones per frame, extra zones only push their debug group.
+#define GPU_PROFILER_HISTORY   240  // Frames kept by the rolling graph and the CSV export.
+#define GPU_PROFILER_CSV_PATH  "gpu_profile.csv"
+
+namespace Renderer
+{
+	// Zone of the last read back frame, in begin order.
+	struct GpuZoneResult
+	{
+		const char*  name;
+		unsigned int depth;
+		float        ms;
+	};
+
+	// GPU time of a read back frame, from its first to its last timestamp.
+	struct GpuFrameTime
+	{
+		unsigned long long frame; // Index given to BeginFrame.
+		float              ms;
+	};
+
+	// Rolling times of a zone, ring indexed by GpuProfiler::historyFrame.
+	struct GpuZoneHistory
+	{
+		const char*  name;
+		unsigned int depth;
+		float        ms[GPU_PROFILER_HISTORY];
+	};
+
+	// Nested GPU zones timed with pools of timestamp queries and labelled with debug groups.
+	// Zone names must be string literals, they are kept by pointer.
+	// Results belong to the render thread, the main thread reads their copy in FrameQueue::renderStats.
+	class GpuProfiler
+	{
+	public:
+		static std::vector<GpuZoneResult>  zones;
+		static std::vector<GpuZoneHistory> history;
+		static unsigned int historyFrame;
+		static unsigned int droppedFrames; // Frames whose queries were not available in time.
+		static std::vector<GpuFrameTime> frameTimes; // Frames read back, appended until cleared by the caller.
+		static bool exportRequested;        // Set from the user interface, handled by the main thread.
+
+		static void Init();
+		static void BeginFrame(const unsigned long long& index); // Read back the frame issued GPU_PROFILER_LATENCY frames ago.
+		static void Begin(const char* name);
+		static void End();
+		static void Flush(); // Wait for the frames in flight and read them back, e.g. before a benchmark report.
+		static void Unload();
+
+		static float GetMs(const char* name); // Last read back time of a zone, 0 if it did not run.
+		static float GetMs(const std::vector<GpuZoneResult>& results, const char* name);
+		static bool  ExportCSV(const std::string& path, const std::vector<GpuZoneHistory>& zoneHistory, const unsigned int& oldestFrame);
+
+	private:
+		struct FrameQueries
+		{
+			GLuint       queries[GPU_PROFILER_MAX_ZONES * 2]; // Begin and end timestamps of each zone.
+			const char*  names[GPU_PROFILER_MAX_ZONES];
+			unsigned int depths[GPU_PROFILER_MAX_ZONES];
+			unsigned int count;
+			int          lastQuery; // Issued last, available once the whole frame is.
+			unsigned long long index;
+		};
+
+		static FrameQueries frames[GPU_PROFILER_LATENCY];
+		static unsigned int frame;
+		static std::vector<int> openZones; // Zone of each open debug group, -1 when untimed.
+
+		static void ReadBack(FrameQueries& queries);
+	};
+
+	// Times the enclosing scope.
+	class GpuZone
+	{
+	public:
+		GpuZone(const char* name) { GpuProfiler::Begin(name); }
+		~GpuZone()                { GpuProfiler::End(); }
+	};
+}
\ No newline at end of file
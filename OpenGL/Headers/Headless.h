@@ -0,0 +1,73 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <string>
+#include <vector>
+
+#include <Vector3.h>
+#include <Camera.h>
+
+#define HEADLESS_TIMESTEP (1.f / 60) // Fixed delta time of headless frames, in seconds.
+
+namespace Core
+{
+	// Native creates an invisible GLFW window. EGL (surfaceless Mesa) and OSMesa contexts need neither GLFW nor a display,
+	// they are only available when built with HEADLESS_EGL or HEADLESS_OSMESA.
+	enum class ContextAPI { Native, EGL, OSMesa };
+
+	// Command line options of a headless run, the benchmark replay also applies to windowed runs.
+	struct HeadlessSettings
+	{
+		bool         enabled      = false;
+		ContextAPI   api          = ContextAPI::Native;
+		int          width        = 1280, height = 720;
+		unsigned int frames       = 600;
+		std::string  cameraPath;      // Keyframes file, replaces the frames count by its duration.
+		std::string  benchmarkPath;   // Camera recording replayed at fixed timestep, replaces the frames count by its length.
+		std::string  outputDirectory; // Frames are saved as PNG when not empty.
+		unsigned int saveInterval = 1;
+	};
+
+	struct CameraKey
+	{
+		float time;
+		Core::Maths::Vector3 position;
+		float pitch, yaw;
+	};
+
+	// Camera keyframes linearly interpolated, one "time x y z pitch yaw" line each, '#' starts a comment.
+	class CameraPath
+	{
+	public:
+		bool  Load(const std::string& path);
+		bool  IsEmpty()     const;
+		float GetDuration() const;
+		void  Apply(Renderer::Camera& camera, const float& time) const;
+
+	private:
+		std::vector<CameraKey> m_keys;
+	};
+
+	// Windowless GL context of the EGL and OSMesa APIs, current on the creating thread.
+	class HeadlessContext
+	{
+	public:
+		static bool  Create(const HeadlessSettings& settings, const int& glVersionMajor, const int& glVersionMinor);
+		static void* GetProcAddress(const char* name); // GL loader of the created context.
+		static void  Destroy();
+
+	private:
+		static ContextAPI api;
+		static void* display; // EGL display.
+		static void* context;
+		static std::vector<unsigned char> buffer; // OSMesa color buffer, frames are rendered offscreen anyway.
+	};
+
+	class Headless
+	{
+	public:
+		static bool ParseArguments(const int& argc, char** argv, HeadlessSettings& settings); // False on invalid options.
+		static bool SaveFrame(const GLuint& framebuffer, const int& width, const int& height, const std::string& path);
+	};
+}
\ No newline at end of file
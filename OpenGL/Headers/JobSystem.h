@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#define JOB_MAX_WORKERS      16
+#define JOB_EXTERNAL_THREADS 2    // Main and render threads, which submit jobs and help while waiting.
+#define JOB_DEQUE_CAPACITY   1024 // Power of two, a full deque runs new jobs inline.
+#define JOB_POOL_SIZE        4096 // Jobs allocated in turn by each thread, a slot still queued or running is not reused.
+#define JOB_GRAIN            256  // Items per job of the per-frame loops.
+#define JOB_TRACE_FRAMES     120
+
+namespace Core
+{
+	// Pending jobs count, waited for by the jobs depending on them.
+	struct JobCounter
+	{
+		std::atomic<unsigned int> pending = 0;
+	};
+
+	struct Job
+	{
+		std::function<void()> task;
+		JobCounter* counter;
+		std::atomic<bool> live = false; // Queued or running, released once its task returned.
+	};
+
+	// Chase-Lev work stealing deque: the owner pushes and pops at the bottom, other threads steal at the top.
+	class JobDeque
+	{
+	public:
+		bool Push(Job* job); // Owner only, false when full.
+		Job* Pop();          // Owner only, newest job first.
+		Job* Steal();        // Any thread, oldest job first.
+
+	private:
+		std::atomic<int64_t> m_top    = 0;
+		std::atomic<int64_t> m_bottom = 0;
+		std::atomic<Job*>    m_jobs[JOB_DEQUE_CAPACITY] = {};
+	};
+
+	// Per-thread activity of the last frames, workers first then the external threads.
+	struct JobThreadTrace
+	{
+		float utilization[JOB_TRACE_FRAMES]; // Busy fraction of each frame, ring indexed by traceFrame.
+		float busyMs;                        // Last frame.
+		unsigned int jobs, steals;           // Last frame.
+	};
+
+	// Work stealing scheduler sized to the core count: per-thread deques, job counters for dependencies,
+	// and threads waiting for a counter execute pending jobs instead of blocking.
+	class JobSystem
+	{
+	public:
+		static std::vector<JobThreadTrace> trace;
+		static unsigned int traceFrame;
+
+		static void Init();           // Start the workers, the calling thread is the main one.
+		static void RegisterThread(); // Give the calling thread a deque, required to submit jobs.
+		static void Run(JobCounter& counter, const std::function<void()>& task);
+		static void ParallelFor(const size_t& count, const size_t& grain, const std::function<void(const size_t& begin, const size_t& end)>& task);
+		static void Wait(JobCounter& counter); // Execute pending jobs until the counter reaches zero.
+		static void EndFrame();       // Record the threads utilization of the frame.
+		static void Unload();
+
+		static unsigned int GetWorkerCount();
+
+	private:
+		struct ThreadData
+		{
+			JobDeque deque;
+			Job      jobs[JOB_POOL_SIZE];
+			unsigned int nextJob = 0;
+			std::atomic<uint64_t>     busyNs = 0;
+			std::atomic<unsigned int> executed = 0, stolen = 0;
+		};
+
+		static ThreadData* threads;
+		static std::vector<std::thread> workers;
+		static std::atomic<unsigned int> threadCount; // Registered threads.
+		static std::atomic<unsigned int> queued;      // Jobs pushed and not taken yet.
+		static std::atomic<bool> running;
+		static double frameStart;
+
+		static Job* GetJob(const unsigned int& self);
+		static void Execute(Job* job, const unsigned int& self);
+		static void WorkerLoop(const unsigned int& index);
+	};
+}
\ No newline at end of file
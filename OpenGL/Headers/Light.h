@@ -9,12 +9,22 @@
 
 namespace Renderer
 {
+	// Light std430 layout, mirrored by the fragment shader Light structure.
+	struct LightData
+	{
+		Core::Maths::Vector4 ambient;   // w: range.
+		Core::Maths::Vector4 diffuse;   // w: linear.
+		Core::Maths::Vector4 specular;  // w: quadratic.
+		Core::Maths::Vector4 position;  // w: inner cone.
+		Core::Maths::Vector4 direction; // w: outer cone.
+	};
+
 	class Light
 	{
 	public:
 		Light();
 
-		// Point light constructor.
+		// Point light constructor, lighting nothing past range (a zero range lights the whole scene).
 		Light(const Core::Maths::Vector3& ambient,
 			  const Core::Maths::Vector3& diffuse,
 			  const Core::Maths::Vector3& specular,
@@ -30,18 +40,19 @@ namespace Renderer
 			  const Core::Maths::Vector3& position,
 			  const Core::Maths::Vector3& direction);
 
-		// Spotlight constructor.
+		// Spotlight constructor (a zero range lights the whole scene).
 		Light(const Core::Maths::Vector3& ambient,
 			  const Core::Maths::Vector3& diffuse,
 			  const Core::Maths::Vector3& specular,
 			  const Core::Maths::Vector3& position,
 			  const Core::Maths::Vector3& direction,
 			  const float& innerCone,
-			  const float& outerCone);
+			  const float& outerCone,
+			  const float& range = 0);
 
 		void operator=(const Light& light);
 
-		void UpdateShader(const unsigned int& id);
+		LightData GetData() const;
 
 	private:
 		float m_range, m_linear, m_quadratic;
@@ -4,17 +4,57 @@
 
 #include <Light.h>
 
-#define MAX_LIGHTS 10
+#define LIGHTS_BINDING          1  // Shader storage binding of the lights buffer.
+#define CLUSTERS_BINDING        9  // Shader storage binding of the clusters light ranges.
+#define CLUSTER_LIGHTS_BINDING  10 // Shader storage binding of the clusters light indices.
+
+// View frustum froxels grid, mirrored by the AssignLights and fragment shaders.
+#define CLUSTER_X               16
+#define CLUSTER_Y               9
+#define CLUSTER_Z               24 // Exponential depth slices between camera near and far.
+#define CLUSTER_COUNT           (CLUSTER_X * CLUSTER_Y * CLUSTER_Z)
+#define CLUSTER_LIGHTS_BUDGET   64 // Average light indices per cluster in the shared index list.
 
 namespace Renderer
 {
+	// Lights buffer header, followed by count LightData.
+	struct LightsHeader
+	{
+		unsigned int count;
+		unsigned int padding[3];
+	};
+
+	// Lights changed during a frame, collected by the main thread and uploaded by the render thread.
+	struct LightSnapshot
+	{
+		unsigned int count;
+		bool countChanged;
+		std::vector<unsigned int> ids; // Increasing indices of the changed lights.
+		std::vector<LightData> data;
+	};
+
 	class LightManager
 	{
 	public:
-		static Light lights[MAX_LIGHTS];
+		static std::vector<Light> lights;
 
 		static void Init();
 		static void SetLight(const Renderer::Light& light, const unsigned int& id);
-		static void Update();
+		static unsigned int AddLight(const Renderer::Light& light);
+		static void Clear(const unsigned int& first = 0); // Remove lights from first onward.
+		static void Collect(LightSnapshot& output); // Main thread: changes since the last collect.
+		static bool HasChanges();                   // Main thread: lights changed since the last collect.
+		static void Upload(const LightSnapshot& changes, const bool& assignClusters = true); // Clusters are only read by forward shading.
+		static void Unload();
+
+	private:
+		static GLuint       buffer, clustersBuffer, clusterLightsBuffer;
+		static GLuint       assignProgram;
+		static unsigned int capacity; // Lights the buffer can hold, only known by the render thread.
+		static bool         countDirty;
+		static std::vector<bool> dirty;
+
+		static void Reserve(const unsigned int& count);
+		static void AssignLights();
 	};
 }
@@ -4,8 +4,10 @@
 
 #include <IResource.h>
 #include <Vertex.h>
+#include <Bounds.h>
 #include <Texture.h>
 #include <ParserOBJ.h>
+#include <GeometryPool.h>
 
 namespace Resources
 {
@@ -17,15 +19,17 @@ namespace Resources
         uint32_t verticesCount;
         std::vector<Core::Maths::Vertex> vertices;
         std::vector<uint32_t> indices;
+        Core::Maths::Bounds bounds; // Local space bounds of the vertices.
     };
 
     class Mesh : public IResource
     {
     public:
-		GLuint VAO, VBO, EBO;
+        GeometryRange range; // Mesh vertices and indices inside the geometry pool.
         
         Texture* texture;
         MeshData data;
+        std::vector<Core::Maths::Vector3> positions; // Kept with data indices for CPU occlusion.
 
         Mesh();
         Mesh(const char* objectPath, const char* texturePath);
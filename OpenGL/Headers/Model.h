@@ -17,11 +17,13 @@ namespace Renderer
 		Model();
 		Model(const char* name, const char* objectPath, const char* texturePath);
 
-		void Draw(const Camera& camera, const GLuint& sampler);
-
 		Resources::Mesh* GetMesh();
+
+		void SetOccluder(const bool& occluder);
+		bool IsOccluder() const;
 	
 	private:
 		Resources::Mesh* m_mesh;
+		bool m_occluder = false; // Rasterized in the occlusion depth buffer.
 	};
 }
\ No newline at end of file
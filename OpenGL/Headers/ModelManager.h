@@ -1,22 +1,118 @@
 #pragma once
 
 #include <unordered_map>
+#include <vector>
 
 #include <Camera.h>
 #include <Model.h>
+#include <RenderQueue.h>
+#include <FrustumCuller.h>
+#include <OcclusionCuller.h>
+#include <FrameRing.h>
+#include <CommandBuffer.h>
+#include <JobSystem.h>
+
+#define INSTANCES_BINDING 2 // Shader storage binding of the instances transforms.
 
 namespace Renderer
 {
+	// Per-instance std430 layout, mirrored by the vertex shader Instances buffer.
+	struct InstanceData
+	{
+		float model[16];
+	};
+
+	// Consecutive queue items sharing program, mesh and texture, drawn as one instanced command.
+	struct InstanceBatch
+	{
+		Resources::Mesh* mesh;
+		GLuint program;
+		GLuint texture;
+		unsigned int first, count;
+	};
+
+	// Indirect draw layout expected by glMultiDrawElementsIndirect.
+	struct DrawCommand
+	{
+		GLuint count;
+		GLuint instanceCount;
+		GLuint firstIndex;
+		GLint  baseVertex;
+		GLuint baseInstance;
+	};
+
+	// Model copied in the snapshot rebuilding the GPU scene.
+	struct GpuSceneObject
+	{
+		Core::Scene::SceneNode* node; // Key of the moved transforms sent by the next snapshots.
+		Resources::Mesh*        mesh;
+		Core::Maths::Bounds     bounds; // Mesh space.
+		InstanceData            transform;
+	};
+
+	// Draws of one frame, built by the main thread and uploaded by the render thread.
+	struct DrawSnapshot
+	{
+		bool gpuCulling;
+		bool hiZCulling;       // GPU culling against last frame depth.
+		bool validateCommands;
+		bool rebuildGpuScene;  // Models were added, the GPU scene is built again from the objects.
+		std::vector<GpuSceneObject> objects;  // GPU scene rebuild: every model.
+		std::vector<InstanceBatch> batches;   // In sort key order.
+		std::vector<InstanceData>  instances; // Transforms ordered by batch.
+		std::vector<std::pair<Core::Scene::SceneNode*, InstanceData>> moved; // GPU culling: transforms of the moved models.
+	};
+
 	class ModelManager
 	{
 	public:
 		static std::unordered_map<std::string, Model*> models;
+		static RenderQueueStats stats;    // Render thread, read through FrameQueue::renderStats.
+		static CullingStats cullingStats;
+		static OcclusionStats occlusionStats;
+		static CommandStats commandStats; // Render thread: packets replayed by this frame draws.
+		static bool validateCommands;     // Check merged command buffers before replaying them, copied in each snapshot.
+		static bool occlusionCulling;
+		static bool gpuCulling; // Cull and build draws in compute shaders instead.
 
+		static void Init(const GLuint& program);
 		static void AddModel(std::string name, const char* objPath, const char* ambientPath);
-		static void DrawModels(const Camera& camera, const GLuint& sampler);
+		static void BeginOcclusion(const Camera& camera); // Start rasterizing occluders, waited for by BuildDraws.
+		static void BuildDraws  (const Camera& camera, DrawSnapshot& output); // Main thread: cull and sort the visible models.
+		static void UploadDraws (const DrawSnapshot& draws);                  // Render thread: upload draws submitted by the passes.
+		static void SubmitDraws (const GLuint& sampler, const GLuint& passProgram = 0); // Models program when no pass program is given.
+		static void SubmitDepth (const GLuint& depthProgram);                          // From the position only vertex stream.
 		
 		static Model* GetModel(const char* name);
 
 		static void Unload();
+
+	private:
+		static GLuint program;
+		static bool   gpuSubmit;                   // Uploaded draws were culled on the GPU.
+		static bool   validateSubmit;              // Uploaded draws validate their command buffers.
+		static std::vector<InstanceBatch> batches; // Uploaded batches, in sort key order.
+		static GLuint instanceIdBuffer; // Instances indices, fed to the geometry pool as a per-instance attribute.
+		static unsigned int instanceCapacity;
+		static RingAllocation instanceData; // Instances transforms ordered by batch, in the frame ring.
+		static RingAllocation commandData;  // Indirect draw commands, one per batch.
+		static std::vector<CommandBuffer> recorders; // One per chunk of batches, recorded by worker threads.
+		static CommandBuffer commands;               // Merged buffer replayed by the render thread.
+		static std::vector<Model*> drawList; // Render queue payloads.
+		static RenderQueue queue;
+		static std::vector<void*> visibleNodes; // Models left by the frustum and occlusion culling.
+		static OcclusionCuller occlusion;
+		static Core::JobCounter occlusionJob; // Occluders rasterization, waited for by the culling.
+		static bool occlusionStarted;
+		static bool gpuSceneDirty; // Models were added since the GPU scene was built.
+
+		static void Cull(const Camera& camera);
+		static void BuildQueue(const Camera& camera);
+		static void BuildBatches(DrawSnapshot& output);
+		static void ExecuteBatches(const GLuint& sampler, const GLuint& passProgram);
+		static void RecordBatches(CommandBuffer& output, const size_t& firstBatch, const GLuint& passProgram);
+		static void RecordSetup(CommandBuffer& output, const GLuint& vertexArray);
+		static void ReplayCommands(const unsigned int& recordedBuffers);
+		static void ReserveInstances(const unsigned int& count);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <Vector3.h>
+#include <Matrix.h>
+#include <Bounds.h>
+
+// Software depth buffer size, in pixels (multiples of the tile size).
+#define OCCLUSION_WIDTH     256
+#define OCCLUSION_HEIGHT    128
+#define OCCLUSION_TILE_SIZE 32
+
+namespace Renderer
+{
+	// Occlusion counters of the last frame.
+	struct OcclusionStats
+	{
+		unsigned int occluderTriangles; // Triangles rasterized after near clipping.
+		unsigned int tested;
+		unsigned int occluded;
+		float rasterMs;                 // Time to transform, rasterize and build the pyramid.
+	};
+
+	// Occluder mesh and its transform for the frame.
+	struct Occluder
+	{
+		const std::vector<Core::Maths::Vector3>* positions;
+		const std::vector<uint32_t>* indices;
+		float model[16];
+	};
+
+	// Occluder triangle in screen space, depth stored as 1/w (0 is infinitely far).
+	struct ScreenTriangle
+	{
+		float x[3], y[3], invW[3];
+	};
+
+	// Rasterizes occluders into a small depth buffer and tests bounds against its min depth pyramid.
+	class OcclusionCuller
+	{
+	public:
+		void Begin(const Core::Maths::Matrix4& viewProj, const float& nearDistance);
+		void AddOccluder(const std::vector<Core::Maths::Vector3>& positions, const std::vector<uint32_t>& indices, const Core::Maths::Matrix4& model);
+		void Rasterize(); // Transform and rasterize occluders on worker threads, then build the pyramid.
+
+		// Remove occluded scene nodes, keeping the others order.
+		OcclusionStats Filter(std::vector<void*>& nodes) const;
+		bool IsVisible(const Core::Maths::Bounds& bounds) const;
+
+		const std::vector<float>& GetDepth() const;
+
+	private:
+		float m_viewProj[16];
+		float m_near = 0;
+		std::vector<Occluder> m_occluders;
+		std::vector<ScreenTriangle> m_triangles;
+		std::vector<std::vector<uint32_t>> m_bins; // Triangles overlapping each tile.
+		std::vector<std::vector<float>> m_levels;  // Depth pyramid, level 0 is the depth buffer.
+		float m_rasterMs = 0;
+
+		void TransformOccluders();
+		void RasterizeTile(const unsigned int& tile);
+		void BuildPyramid();
+	};
+}
\ No newline at end of file
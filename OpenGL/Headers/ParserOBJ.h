@@ -5,6 +5,7 @@
 #include <unordered_map>
 
 #include <Vertex.h>
+#include <Bounds.h>
 
 namespace Resources
 {
@@ -27,5 +28,6 @@ namespace Resources
 		Core::Maths::Vector3  ParseVector3(const char* cursor);
 		Core::Maths::Vector2  ParseVector2(const char* cursor);
 		std::vector<IndexOBJ> ParseIndices(const char* cursor);
+		Core::Maths::Bounds   ComputeBounds(const std::vector<Core::Maths::Vertex>& vertices);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#define PROGRAM_CACHE_MAGIC 0x50434247 // "GBCP" (GL binary cache program).
+
+namespace Resources
+{
+	struct ProgramCacheHeader
+	{
+		uint32_t magic;
+		uint64_t key;
+		GLenum   format;
+		GLint    length;
+	};
+
+	class ProgramCache
+	{
+	public:
+		static std::string directory; // Folder where program binaries are stored.
+
+		// Hash of the given shader sources (defines included) and of the GL renderer / version strings.
+		static uint64_t GetKey(const std::vector<std::string>& sources);
+
+		static bool Load(const GLuint& program, const uint64_t& key);
+		static void Save(const GLuint& program, const uint64_t& key);
+
+	private:
+		static std::string GetPath(const uint64_t& key);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Sort key layout, most significant fields first so that sorting groups state changes.
+#define SORT_KEY_PASS_BITS    4
+#define SORT_KEY_PROGRAM_BITS 8
+#define SORT_KEY_TEXTURE_BITS 12
+#define SORT_KEY_MESH_BITS    16
+#define SORT_KEY_DEPTH_BITS   24
+
+namespace Renderer
+{
+	enum class RenderPass : uint8_t { Opaque };
+
+	// A draw to sort: its sort key and the index of what to draw.
+	struct RenderItem
+	{
+		uint64_t key;
+		uint32_t payload;
+	};
+
+	// Execution counters, compared to binding every state for every draw.
+	struct RenderQueueStats
+	{
+		unsigned int items;
+		unsigned int batches;
+		unsigned int multiDraws;
+		unsigned int binds;
+		unsigned int bindsAvoided;
+		unsigned int triangles; // Drawn by the lit pass, instances included. Not read back with GPU culling.
+	};
+
+	class RenderQueue
+	{
+	public:
+		// Build a sort key (depth is normalized between 0 and 1, front to back).
+		// Program, texture and mesh are truncated to their field bits: equal keys only group states, they do not identify them.
+		static uint64_t MakeKey(const RenderPass& pass, const unsigned int& program, const unsigned int& texture, const unsigned int& mesh, const float& depth);
+
+		// Key without the depth field: items sharing it share all their states.
+		static uint64_t GetStateKey(const uint64_t& key);
+
+		void Clear();
+		void Push(const uint64_t& key, const uint32_t& payload);
+		void Resize(const size_t& count);  // Items are then written with Set, from any thread.
+		void Set(const size_t& index, const uint64_t& key, const uint32_t& payload);
+		void Sort(); // LSD radix sort on keys, stable.
+
+		const std::vector<RenderItem>& GetItems() const;
+
+	private:
+		std::vector<RenderItem> m_items;
+		std::vector<RenderItem> m_scratch;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <GpuProfiler.h>
+
+#define RESOLUTION_SCALE_STEP 0.05f // Applied scales are multiples of it, so that the scene targets are seldom resized.
+#define RESOLUTION_DEADBAND   0.05f // Relative error of the frame time ignored by the controller.
+#define RESOLUTION_RATE       0.25f // Fraction of the scale error corrected each frame.
+
+namespace Renderer
+{
+	// Copied in each frame snapshot.
+	struct ResolutionSettings
+	{
+		bool  enabled;
+		float targetMs;           // GPU frame budget.
+		float minScale, maxScale; // Per axis, of the framebuffer size.
+	};
+
+	// Renders the scene in an offscreen color and depth target at a fraction of the framebuffer resolution,
+	// scaled so that the GPU frame time reported by the profiler meets its target, then upscales it before the interface.
+	class ResolutionScaler
+	{
+	public:
+		static ResolutionSettings settings;
+		static float scale;       // Render thread: applied last frame.
+		static int   width, height;
+
+		static void Update(const ResolutionSettings& settings); // Once per frame, after the profiler read back.
+		static void Begin(const int& outputWidth, const int& outputHeight, int& sceneWidth, int& sceneHeight);
+		static void End();       // Upscale the scene to the framebuffer bound at Begin.
+		static void Unload();
+
+	private:
+		static float  desiredScale;
+		static float  scales[GPU_PROFILER_LATENCY]; // Applied scale of the frames not read back yet, 0 when not scaled.
+		static unsigned int frame;
+		static GLuint framebuffer, color, depth;
+		static int    targetWidth, targetHeight;
+		static GLint  output;
+		static int    outputWidth, outputHeight;
+
+		static void Reserve(const int& width, const int& height);
+	};
+}
\ No newline at end of file
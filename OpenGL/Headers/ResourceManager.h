@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <unordered_map> // More optimized than map.
 
 namespace Resources
@@ -8,6 +9,9 @@ namespace Resources
 	class Texture;
 	class Shader;
 	class Mesh;
+	class ShaderReflection;
+
+	enum class ShaderType;
 
 	class ResourceManager
 	{
@@ -18,10 +22,16 @@ namespace Resources
 		static std::unordered_map<const char*, Shader>  shaders;
 		static std::unordered_map<const char*, Mesh>    meshes;
 
+		static std::unordered_map<GLuint, ShaderReflection> reflections; // Linked programs active uniforms and blocks.
+
 		template<typename T> static T*   Create(const char* path, ...);
 		template<typename T> static T*   Get   (const char* path);
 		template<typename T> static void Unload(const char* path);
 
+		// Build a program from shader stages, loaded from the program binary cache when possible.
+		static GLuint CreateProgram(const std::vector<std::pair<const char*, ShaderType>>& stages, const std::string& defines = "");
+		static ShaderReflection* GetReflection(const GLuint& program);
+
 		static void Unload();
 	};
 }
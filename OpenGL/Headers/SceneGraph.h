@@ -3,6 +3,7 @@
 #include <unordered_map>
 
 #include <Model.h>
+#include <BVH.h>
 
 namespace Core::Scene
 {
@@ -12,10 +13,14 @@ namespace Core::Scene
 	{
 	public:
 		static inline std::unordered_map<std::string, SceneNode*> nodes;
+		static inline BVH bvh; // Bounded nodes hierarchy.
+		static inline std::vector<SceneNode*> movedNodes; // Bounded nodes moved since the last draw, once each.
 
 		static inline SceneNode* AddNode(const std::string& name, SceneNode* node);
 		static inline SceneNode* AddNode(const string& name, Renderer::Model* node);
 		static inline SceneNode* GetNode(const std::string& name);
+		static inline void QueueMoved(SceneNode* node);
+		static inline void ClearMoved(); // Once the moved nodes are consumed.
 
 		static inline void Unload();
 	};
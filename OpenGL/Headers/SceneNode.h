@@ -3,6 +3,7 @@
 #include <Vector3.h>
 #include <Transform.h>
 #include <Matrix.h>
+#include <Bounds.h>
 
 namespace Core::Scene
 {
@@ -13,6 +14,8 @@ namespace Core::Scene
 		std::string name;
 		Core::Maths::Transform transform;
 		Core::Maths::Matrix4 mat;
+		Core::Maths::Bounds localBounds; // Bounds of the node content.
+		Core::Maths::Bounds worldBounds; // Local bounds transformed by mat.
 	};
 
 	class SceneNode
@@ -26,9 +29,15 @@ namespace Core::Scene
 		void SetPosition(const Core::Maths::Vector3& position);
 		void SetRotation(const Core::Maths::Vector3& rotation);
 		void SetScale   (const Core::Maths::Vector3& scale);
+		void SetLocalBounds(const Core::Maths::Bounds& bounds);
+		void SetProxy(const int& proxy);
 		void UpdateMat(const Core::Maths::Transform& transform);
 
 	private:
+		friend class SceneGraph;
+
 		SceneNodeData m_data;
+		int  m_proxy = -1;     // Leaf in the scene graph hierarchy, if any.
+		bool m_moved = false;  // Queued in SceneGraph::movedNodes.
 	};
 }
\ No newline at end of file
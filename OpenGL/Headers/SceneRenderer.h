@@ -0,0 +1,55 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <Camera.h>
+
+#define GBUFFER_ALBEDO_UNIT 4 // Texture units read by the tiled lighting pass.
+#define GBUFFER_NORMAL_UNIT 5
+#define GBUFFER_DEPTH_UNIT  6
+#define LIGHTING_TILE_SIZE  16 // Pixels per side of a tiled lighting workgroup.
+
+namespace Renderer
+{
+	struct SceneSnapshot;
+
+	enum class RenderPath { Forward, Deferred };
+
+	// GPU time of each pass in milliseconds from the profiler zones, only updated for the passes of the rendered path.
+	struct RenderPassTimings
+	{
+		float lightAssignment; // Forward clusters.
+		float prepass;         // Forward depth pre-pass.
+		float forward;
+		float geometry;        // Deferred G-buffer.
+		float lighting;
+		float composite;
+	};
+
+	class SceneRenderer
+	{
+	public:
+		static RenderPath path;   // Copied in each frame snapshot.
+		static bool depthPrepass; // Forward only: lay depth first, then shade each pixel once.
+
+		// Render thread, read through FrameQueue::renderStats.
+		static RenderPath renderedPath; // Path of the last frame, whatever the snapshot path once deferred failed.
+		static bool deferredFailed;     // The G-buffer could not be created, never retried.
+		static RenderPassTimings timings;
+
+		static void Init();
+		static void Render(const SceneSnapshot& snapshot, const GLuint& sampler);
+		static void Unload();
+
+	private:
+		static GLuint gBufferProgram, lightingProgram, depthProgram;
+		static GLuint gBuffer, albedoTexture, normalTexture, depthTexture;
+		static GLuint litFramebuffer, litTexture;
+		static int    width, height;
+
+		static void RenderForward (const SceneSnapshot& snapshot, const GLuint& sampler);
+		static void RenderDeferred(const SceneSnapshot& snapshot, const GLuint& sampler);
+		static void ResizeTargets(const int& width, const int& height);
+		static void DeleteTargets();
+	};
+}
\ No newline at end of file
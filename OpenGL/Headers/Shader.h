@@ -2,17 +2,19 @@
 
 #include <glad/glad.h>
 
+#include <string>
+
 #include <IResource.h>
 
 namespace Resources
 {
-	enum class ShaderType{ EmptyShader, VertexShader, FragmentShader };
+	enum class ShaderType{ EmptyShader, VertexShader, FragmentShader, ComputeShader };
 
 	class Shader : public IResource
 	{
 	public:
 		Shader();
-		Shader(const char* path, const ShaderType& type);
+		Shader(const char* path, const ShaderType& type, const std::string& defines = "");
 
 		void Create(const char* path) override;
 		void Unload()				  override;
@@ -21,11 +23,15 @@ namespace Resources
 
 		void SetVertexShader();
 		void SetFragmentShader();
+		void SetComputeShader();
 
 		bool CheckShaderCompilation();
 
+		static std::string ReadSource(const char* path, const std::string& defines);
+
 	private:
-		GLuint     m_shader;
-		ShaderType m_type;
+		GLuint      m_shader;
+		ShaderType  m_type;
+		std::string m_defines;
 	};
 }
\ No newline at end of file
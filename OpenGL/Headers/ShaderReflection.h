@@ -0,0 +1,42 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <string>
+#include <vector>
+
+namespace Resources
+{
+	// Active default block uniform of a linked program.
+	struct UniformInfo
+	{
+		std::string name;
+		GLint  location;
+		GLenum type;
+		GLint  size;
+	};
+
+	// Active uniform / shader storage block of a linked program.
+	struct BlockInfo
+	{
+		std::string name;
+		GLenum interface;
+		GLint  binding;
+		GLint  dataSize;
+	};
+
+	class ShaderReflection
+	{
+	public:
+		std::vector<UniformInfo> uniforms; // Sorted by name.
+		std::vector<BlockInfo>   blocks;
+
+		void Reflect(const GLuint& program);
+
+		GLint            GetLocation(const std::string& name) const; // Returns -1 for inactive uniforms.
+		const BlockInfo* GetBlock   (const std::string& name) const; // Returns nullptr for inactive blocks.
+
+		// Location of a uniform from the reflection of the given program.
+		static GLint FindLocation(const GLuint& program, const std::string& name);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <string>
+
+namespace Resources
+{
+	// Typed handle to a program uniform, resolved once from the program reflection.
+	template<typename T>
+	class Uniform
+	{
+	public:
+		Uniform();
+		Uniform(const GLuint& program, const std::string& name);
+
+		void Set(const T& value) const;
+		bool IsActive() const;
+
+	private:
+		GLuint m_program;
+		GLint  m_location;
+	};
+}
+
+#include "Uniform.inl"
\ No newline at end of file
@@ -4,22 +4,35 @@
 #include <ImGui/imgui.h>
 
 #include <vector>
+#include <mutex>
+
+#include <Debug.h>
 
 namespace Core::UI
 {
 	enum class UIStyle { CLASSIC, LIGHT, DARK };
 
+	// Copy of a frame ImGui draw lists, rendered while the next frame is built.
+	struct UIDrawData
+	{
+		ImDrawData               drawData;
+		std::vector<ImDrawList*> lists;
+	};
+
 	class UserInterface
 	{
 	public:
 		// Static log buffer appended by the LogSystem class.
 		static int maxMessages;
 		static std::vector<std::pair<Core::Debug::LogType, std::string>> logBuffer;
+		static std::mutex logMutex;
 
 		static void Init(GLFWwindow* window, const int& glMajorVersion, const int& glMinorVersion, const UIStyle& style = UIStyle::DARK);
 
-		static void Update();
-		static void Draw();
+		static void Update();                     // Build the interface, on the main thread.
+		static void Capture(UIDrawData& output);  // Copy the built draw lists.
+		static void Draw(UIDrawData& drawData);   // Render copied draw lists, on the render thread.
+		static void Release(UIDrawData& drawData);
 
 		static void Unload();
 
@@ -30,5 +43,12 @@ namespace Core::UI
 		static void ManageLogs();
 		static void DisplayLogs();
 		static void DisplaySceneGraph();
+		static void DisplayStats();
+		static void DisplayLights();
+		static void DisplayRenderPath();
+		static void DisplayResolution();
+		static void DisplayFramePacing();
+		static void DisplayJobs();
+		static void DisplayProfiler();
 	};
 }
\ No newline at end of file
@@ -4,22 +4,42 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include <STB_Image/stb_image.h>
 
+#include <cstdio>
 #include <iostream>
 #include <string>
 #include <unordered_map>
 #include <vector>
+#include <thread>
 
 #include <Constants.h>
 #include <Debug.h>
 #include <Vertex.h>
 #include <Texture.h>
+#include <GeometryPool.h>
+#include <ShaderReflection.h>
 #include <Model.h>
 #include <Camera.h>
 #include <SceneGraph.h>
 #include <ResourceManager.h>
 #include <ModelManager.h>
 #include <LightManager.h>
+#include <FrameConstants.h>
+#include <FrameRing.h>
 #include <UserInterface.h>
+#include <CullingBenchmark.h>
+#include <GpuCuller.h>
+#include <SceneRenderer.h>
+#include <FrameQueue.h>
+#include <JobSystem.h>
+#include <GpuProfiler.h>
+#include <ResolutionScaler.h>
+#include <GLState.h>
+#include <CpuProfiler.h>
+#include <Clock.h>
+#include <Headless.h>
+#include <CameraRecording.h>
+#include <Benchmark.h>
+#include <FramePacer.h>
 #include <App.h>
 
 using namespace std;
@@ -39,18 +59,52 @@ GLuint ResourceManager::shaderProgram;
 unordered_map<const char*, Resources::Texture> ResourceManager::textures;
 unordered_map<const char*, Resources::Shader>  ResourceManager::shaders;
 unordered_map<const char*, Resources::Mesh>	   ResourceManager::meshes;
+unordered_map<GLuint, Resources::ShaderReflection> ResourceManager::reflections;
 
 // Model Manager static declaration.
 unordered_map<string, Renderer::Model*> ModelManager::models;
+vector<InstanceBatch> ModelManager::batches;
+GLuint       ModelManager::instanceIdBuffer = 0;
+unsigned int ModelManager::instanceCapacity = 0;
+RingAllocation ModelManager::instanceData   = { 0, 0, 0, nullptr };
+RingAllocation ModelManager::commandData    = { 0, 0, 0, nullptr };
+GLuint       ModelManager::program          = 0;
+vector<Renderer::Model*> ModelManager::drawList;
+RenderQueue              ModelManager::queue;
+RenderQueueStats         ModelManager::stats;
+CullingStats             ModelManager::cullingStats;
+vector<void*>            ModelManager::visibleNodes;
+OcclusionStats           ModelManager::occlusionStats;
+OcclusionCuller          ModelManager::occlusion;
+JobCounter               ModelManager::occlusionJob;
+bool                     ModelManager::occlusionStarted = false;
+bool                     ModelManager::occlusionCulling = true;
+bool                     ModelManager::gpuCulling       = false;
+bool                     ModelManager::gpuSceneDirty    = true;
+bool                     ModelManager::gpuSubmit        = false;
+bool                     ModelManager::validateSubmit   = false;
+vector<CommandBuffer>    ModelManager::recorders;
+CommandBuffer            ModelManager::commands;
+CommandStats             ModelManager::commandStats     = {};
+#ifdef _DEBUG
+bool                     ModelManager::validateCommands = true;
+#else
+bool                     ModelManager::validateCommands = false;
+#endif
 
 // ===================================================================
 // Application constructor / destructor.
 // ===================================================================
 
-App::App(unsigned int glVersionMajor, unsigned int glVersionMinor, bool fullScreen)
-	: m_fullScreen(fullScreen)
+App::App(unsigned int glVersionMajor, unsigned int glVersionMinor, bool fullScreen, bool renderThread, const HeadlessSettings& headless)
+	: m_fullScreen(fullScreen && !headless.enabled)
+	, m_renderThread(renderThread && !headless.enabled)
+	, m_headless(headless)
+	, m_offscreenFramebuffer(0), m_offscreenColor(0), m_offscreenDepth(0)
+	, m_replayFrame(0), m_sampleTime(0), m_snapshotFrame(0)
 	, m_glVersionMajor(glVersionMajor)
 	, m_glVersionMinor(glVersionMinor)
+	, m_deltaTime(0), m_lastFrame(0), m_frameSkipped(false)
 {
 	Init();
 }
@@ -64,59 +118,245 @@ App::~App() { Unload(); }
 // Init sequence of the application.
 void App::Init()
 {
+	PROFILE_THREAD("Main");
+	PROFILE_FUNCTION();
+
+	JobSystem::Init();
 	InitGLContext();
-	UserInterface::Init(m_window, m_glVersionMajor, m_glVersionMinor);
+	if (m_headless.enabled) InitOffscreen();
+	else                    UserInterface::Init(m_window, m_glVersionMajor, m_glVersionMinor);
 	InitShaders();
 	LoadScene();
+
+	// Benchmarks replay a camera recording, headless or not.
+	if (!m_headless.benchmarkPath.empty()) m_replay.Load(m_headless.benchmarkPath);
 }
 
 void App::Run()
 {
-	while (!glfwWindowShouldClose(m_window))
+	if (m_headless.enabled)
 	{
-		EarlyUpdate();
-		Render();
-		LateUpdate();
+		RunHeadless();
+		return;
+	}
+
+	if (!m_renderThread)
+	{
+		while (!glfwWindowShouldClose(m_window))
+		{
+			if (EarlyUpdate()) Render();
+			LateUpdate();
+		}
+	}
+	else
+	{
+		// The render thread owns the GL context while the main thread builds the next frame snapshot.
+		glfwMakeContextCurrent(NULL);
+		thread renderThread([this]()
+		{
+			PROFILE_THREAD("Render");
+			glfwMakeContextCurrent(m_window);
+			JobSystem::RegisterThread();
+			while (Render());
+			glfwMakeContextCurrent(NULL);
+		});
+
+		while (!glfwWindowShouldClose(m_window))
+		{
+			EarlyUpdate();
+			LateUpdate();
+		}
+
+		// Frames already published are still presented.
+		FrameQueue::Close();
+		renderThread.join();
+		glfwMakeContextCurrent(m_window);
 	}
+
+	// Windowed benchmarks are reported once the replay is over and its frames presented.
+	if (m_replay.GetFrameCount() > 0 && m_replayFrame == m_replay.GetFrameCount()) ReportBenchmark("Benchmark");
 }
 
 // Application update before rendering
-void App::EarlyUpdate()
+bool App::EarlyUpdate()
 {
-	// GL context refresh.
-	UpdateWindow(m_window);
-	glUseProgram(ResourceManager::shaderProgram);
-		
-	// Delta time.
-	float currentFrame = (float)glfwGetTime();
-	m_deltaTime = currentFrame - m_lastFrame;
+	PROFILE_FUNCTION();
+
+	// Headless runs and replays are never paced nor skipped: benchmarks measure the frame cost.
+	bool replaying = m_replay.GetFrameCount() > 0;
+	bool onDemand  = FramePacer::settings.onDemand && !replaying && !m_headless.enabled;
+	if (!m_headless.enabled)
+	{
+		if (!replaying) FramePacer::Limit();
+		FramePacer::WaitEvents(!onDemand);
+	}
+
+	// Delta time, fixed in headless runs and replays so that they are reproducible.
+	// Time spent idle on skipped frames is not simulated.
+	float currentFrame = m_headless.enabled || replaying ? m_lastFrame + HEADLESS_TIMESTEP : (float)GetTime();
+	m_deltaTime = m_frameSkipped ? 0 : currentFrame - m_lastFrame;
 	m_lastFrame = currentFrame;
 		 
-	// Inputs and camera update.
-	glfwPollEvents();
-	UpdateInputs(m_window, &m_mouseX, &m_mouseY, &m_camera.inputs);
-	m_camera.Update(m_window, m_deltaTime, &m_camera.inputs);
+	// Inputs and camera update, headless cameras are driven by their path or the replay.
+	double inputTime = GetTime();
+	Maths::Vector3 lastPosition = m_camera.GetPosition();
+	float lastPitch = m_camera.GetPitch(), lastYaw = m_camera.GetYaw();
+	if (!m_headless.enabled)
+	{
+		UpdateInputs(m_window, &m_mouseX, &m_mouseY, &m_camera.inputs);
+		if (!replaying) m_camera.Update(m_window, m_deltaTime, &m_camera.inputs);
+	}
+	if      (replaying)                  m_replay.Apply(m_replayFrame, m_camera);
+	else if (CameraRecording::recording) m_recording.Add(m_camera);
+
+	// On-demand frames are only rendered after inputs, camera, transforms or lights changed.
+	if (onDemand)
+	{
+		Maths::Vector3 position = m_camera.GetPosition();
+		bool changed = position.x != lastPosition.x || position.y != lastPosition.y || position.z != lastPosition.z
+			|| m_camera.GetPitch() != lastPitch || m_camera.GetYaw() != lastYaw
+			|| !SceneGraph::movedNodes.empty() || LightManager::HasChanges();
+
+		m_frameSkipped = !FramePacer::ShouldRender(changed);
+		if (m_frameSkipped) return false;
+	}
+	else m_frameSkipped = false;
+
+	// Occluders are rasterized in the background until models are culled.
+	ModelManager::BeginOcclusion(m_camera);
 
 	// User interface.
-	UserInterface::Update();
+	if (!m_headless.enabled) UserInterface::Update();
+
+	// Waits while the render thread is a whole frame behind.
+	SceneSnapshot* snapshot = nullptr;
+	{
+		PROFILE_ZONE("Wait for render thread");
+		snapshot = FrameQueue::Acquire();
+	}
+	m_snapshotFrame        = snapshot->frame;
+	snapshot->inputTime    = inputTime;
+	snapshot->camera       = m_camera;
+	snapshot->time         = currentFrame;
+	snapshot->deltaTime    = m_deltaTime;
+	snapshot->path         = SceneRenderer::path;
+	snapshot->depthPrepass = SceneRenderer::depthPrepass;
+	snapshot->resolution   = ResolutionScaler::settings;
+	snapshot->swapInterval = replaying ? 0 : FramePacer::GetSwapInterval();
+	if (m_headless.enabled)
+	{
+		snapshot->width  = m_headless.width;
+		snapshot->height = m_headless.height;
+	}
+	else glfwGetFramebufferSize(m_window, &snapshot->width, &snapshot->height);
+
+	// Everything the render thread reads is copied in the snapshot.
+	ModelManager::BuildDraws(m_camera, snapshot->draws);
+	LightManager::Collect(snapshot->lights);
+	if (!m_headless.enabled) UserInterface::Capture(snapshot->ui);
+	FrameQueue::Publish(snapshot);
+
+	// Workers utilization of this frame, render thread jobs included.
+	JobSystem::EndFrame();
+	return true;
 }
 
 // Application rendering.
-void App::Render()
+bool App::Render()
 {
-	glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	SceneSnapshot* snapshot = nullptr;
+	{
+		PROFILE_ZONE("Wait for snapshot");
+		snapshot = FrameQueue::Pop();
+	}
+	if (snapshot == nullptr) return false;
+
+	PROFILE_FUNCTION();
+
+	FrameRing::BeginFrame();
+	GpuProfiler::BeginFrame(snapshot->frame);
+	GLState::BeginFrame();
+	ResolutionScaler::Update(snapshot->resolution);
 
-	ModelManager::DrawModels(m_camera, m_sampler);
-	UserInterface::Draw();
+	{
+		GpuZone frameZone("Frame");
+
+		// The scene may be rendered below the framebuffer resolution, then upscaled under the interface.
+		int sceneWidth = snapshot->width, sceneHeight = snapshot->height;
+		glBindFramebuffer(GL_FRAMEBUFFER, m_offscreenFramebuffer);
+		if (snapshot->resolution.enabled) ResolutionScaler::Begin(snapshot->width, snapshot->height, sceneWidth, sceneHeight);
+
+		// Camera matrices and frame data, computed once for all draws.
+		FrameConstants::Update(snapshot->camera, snapshot->time, snapshot->deltaTime, sceneWidth, sceneHeight);
+
+		glViewport(0, 0, sceneWidth, sceneHeight);
+		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		// Forward or deferred shading of the models, lights are shared by all of them.
+		{
+			GpuZone sceneZone("Scene");
+			SceneRenderer::Render(*snapshot, m_sampler);
+		}
+		if (snapshot->resolution.enabled) ResolutionScaler::End();
+		UserInterface::Draw(snapshot->ui);
+	}
+
+	if (!m_headless.enabled)
+	{
+		PROFILE_ZONE("Swap buffers");
+		FramePacer::ApplySwapInterval(snapshot->swapInterval);
+		glfwSwapBuffers(m_window);
+	}
+	FrameRing::EndFrame();
 
-	glfwSwapBuffers(m_window);
+	UpdateFrameResults(snapshot->frame);
+	FrameQueue::Release(snapshot, GetTime(), m_frameResults);
+	return true;
 }
 
 // Application update after rendering.
 void App::LateUpdate()
 {
-	UpdateCursor(m_window, m_mouseX, m_mouseY, &m_camera.inputs);
+	PROFILE_FUNCTION();
+
+	// Results of the last presented frame, read by the interface and the benchmark samples.
+	FrameQueue::CopyRenderStats();
+
+	if (!m_headless.enabled) UpdateCursor(m_window, m_mouseX, m_mouseY, &m_camera.inputs);
+
+	// Saved once stopped from the user interface.
+	if (!CameraRecording::recording && m_recording.GetFrameCount() > 0)
+	{
+		m_recording.Save(CAMERA_RECORDING_PATH);
+		m_recording.Clear();
+	}
+
+	// Windowed benchmarks sample the main loop period, then close once the replay is over.
+	if (m_replay.GetFrameCount() > 0 && !m_headless.enabled)
+	{
+		double now = GetTime();
+		if (m_replayFrame > 0) RecordSample((float)((now - m_sampleTime) * 1000));
+		m_sampleTime = now;
+
+		if (++m_replayFrame == m_replay.GetFrameCount()) glfwSetWindowShouldClose(m_window, GLFW_TRUE);
+	}
+
+	// Requested from the user interface.
+	if (CullingBenchmark::requested) CullingBenchmark::Run(m_camera);
+	if (GpuProfiler::exportRequested)
+	{
+		GpuProfiler::ExportCSV(GPU_PROFILER_CSV_PATH, FrameQueue::renderStats.gpuHistory, FrameQueue::renderStats.gpuHistoryFrame);
+		GpuProfiler::exportRequested = false;
+	}
+
+#ifdef ENABLE_PROFILER
+	if (CpuProfiler::exportRequested)
+	{
+		CpuProfiler::ExportTrace(CPU_PROFILER_TRACE_PATH);
+		CpuProfiler::exportRequested = false;
+	}
+#endif
 }
 
 // Unload all ressources.
@@ -126,14 +366,30 @@ void App::Unload()
 	glDeleteVertexArrays(1, &VAO);
 	glDeleteBuffers(1, &VBO);
 	glDeleteBuffers(1, &EBO);
+	glDeleteFramebuffers(1, &m_offscreenFramebuffer);
+	glDeleteRenderbuffers(1, &m_offscreenColor);
+	glDeleteRenderbuffers(1, &m_offscreenDepth);
 	
 	// Unload resources and user interface.
-	ModelManager   ::Unload();
-	SceneGraph     ::Unload();
-	ResourceManager::Unload();
-	UserInterface  ::Unload();
+	ModelManager    ::Unload();
+	GpuCuller       ::Unload();
+	SceneRenderer   ::Unload();
+	ResolutionScaler::Unload();
+	LightManager    ::Unload();
+	FrameRing       ::Unload();
+	FrameQueue      ::Unload();
+	GpuProfiler     ::Unload();
+	SceneGraph      ::Unload();
+	ResourceManager ::Unload();
+	GeometryPool    ::Unload();
+	if (!m_headless.enabled) UserInterface::Unload();
+	JobSystem       ::Unload();
+#ifdef ENABLE_PROFILER
+	CpuProfiler     ::Unload();
+#endif
 
 	// Glfw: terminate, clearing all previously allocated GLFW resources.
+	if (m_window == NULL) HeadlessContext::Destroy();
 	glfwTerminate();
 }
 
@@ -144,78 +400,98 @@ void App::Unload()
 // Create the OpenGl context and return errors if necessary.
 void App::InitGLContext()
 {
-	// Glfw: initialize and configure.
-	glfwInit();
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, m_glVersionMajor);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, m_glVersionMinor);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-	glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE);
-
-	// Set aspect ratio according to primary monitor size.
-	const GLFWvidmode* mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
-	m_screenWidth = mode->width; m_screenHeight = mode->height;
-	frameAspectRatio = (float)(m_screenWidth / m_screenHeight);
-
-	// Glfw window creation.
-	m_window = glfwCreateWindow(m_screenWidth, m_screenHeight, "ModernGL", m_fullScreen ? glfwGetPrimaryMonitor() : NULL, NULL);
-
-	if (m_window == NULL)
+	m_window = NULL;
+	if (m_headless.enabled && m_headless.api != ContextAPI::Native)
 	{
-		glfwTerminate();
-		throw std::runtime_error("Failed to create GLFW window");
+		// Windowless context, GLFW is never initialized: runs on nodes without any display.
+		if (!HeadlessContext::Create(m_headless, m_glVersionMajor, m_glVersionMinor))
+			throw std::runtime_error("Failed to create the headless GL context");
+		m_screenWidth = m_headless.width; m_screenHeight = m_headless.height;
+	}
+	else
+	{
+		InitWindow();
+		glfwMakeContextCurrent(m_window);
+		if (!m_headless.enabled) FramePacer::Init(m_window);
 	}
-
-	glfwMakeContextCurrent(m_window);
-	glfwSetFramebufferSizeCallback(m_window, framebuffer_size_callback);
 
 	// Glad: load all OpenGL function pointers.
-	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	if (!gladLoadGLLoader(m_window != NULL ? (GLADloadproc)glfwGetProcAddress : (GLADloadproc)HeadlessContext::GetProcAddress))
 		throw std::runtime_error("Failed to initialize GLAD");
 
+	// Nothing is known of the context state yet.
+	GLState::Invalidate();
+
 	// GL flags.
 	GLint flags = 0;
 	glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
 
 	if (flags & GL_CONTEXT_FLAG_DEBUG_BIT)
 	{
-		glEnable(GL_DEBUG_OUTPUT);
-		glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
-		glEnable(GL_DEPTH_TEST);
+		GLState::Enable(GL_DEBUG_OUTPUT);
+		GLState::Enable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+		GLState::Enable(GL_DEPTH_TEST);
 		
 		glDebugMessageCallback(glDebugOutput, nullptr);
 		glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+
+		// Profiler debug groups are only labels for captures.
+		glDebugMessageControl(GL_DONT_CARE, GL_DEBUG_TYPE_PUSH_GROUP, GL_DONT_CARE, 0, nullptr, GL_FALSE);
+		glDebugMessageControl(GL_DONT_CARE, GL_DEBUG_TYPE_POP_GROUP,  GL_DONT_CARE, 0, nullptr, GL_FALSE);
 	}
 }
 
-// Build and compile shader program.
-void App::InitShaders()
+// Create the GLFW window and its context.
+void App::InitWindow()
 {
-	ResourceManager::Create<Shader>("Assets/Shaders/VertexShader.vert",   ShaderType::VertexShader);
-	ResourceManager::Create<Shader>("Assets/Shaders/FragmentShader.frag", ShaderType::FragmentShader);
-	
-	int success; char infoLog[512];
-
-	ResourceManager::shaderProgram = glCreateProgram();
+	// Glfw: initialize and configure.
+	if (!glfwInit())
+		throw std::runtime_error("Failed to initialize GLFW, no window system available (headless runs can use --api=egl or --api=osmesa)");
 
-	// Attach all created shaders to the shader program.
-	for (auto& it : ResourceManager::shaders)
-		glAttachShader(ResourceManager::shaderProgram, it.second.GetShader());
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, m_glVersionMajor);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, m_glVersionMinor);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE);
 
-	// Link shaders.
-	glLinkProgram(ResourceManager::shaderProgram);
+	if (m_headless.enabled)
+	{
+		// The window is never shown, it only holds the context.
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+		m_screenWidth = m_headless.width; m_screenHeight = m_headless.height;
+	}
+	else
+	{
+		// Set aspect ratio according to primary monitor size.
+		const GLFWvidmode* mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+		m_screenWidth = mode->width; m_screenHeight = mode->height;
+	}
 
-	// Check for linking errors.
-	glGetProgramiv(ResourceManager::shaderProgram, GL_LINK_STATUS, &success);
+	// Glfw window creation.
+	m_window = glfwCreateWindow(m_screenWidth, m_screenHeight, "ModernGL", m_fullScreen ? glfwGetPrimaryMonitor() : NULL, NULL);
 
-	if (!success)
+	if (m_window == NULL)
 	{
-		glGetProgramInfoLog(ResourceManager::shaderProgram, 512, NULL, infoLog);
-		Log(LogType::ERROR, string("ERROR::SHADER::PROGRAM::LINKING_FAILED") + infoLog);
+		glfwTerminate();
+		throw std::runtime_error("Failed to create GLFW window");
 	}
+}
 
-	// Unload compiled shaders from memory and clear shaders list.
-	for (auto& it : ResourceManager::shaders) it.second.Unload();
-	ResourceManager::shaders.clear();
+// Build and compile shader program.
+void App::InitShaders()
+{
+	ResourceManager::shaderProgram = ResourceManager::CreateProgram({
+		{ "Assets/Shaders/VertexShader.vert",   ShaderType::VertexShader   },
+		{ "Assets/Shaders/FragmentShader.frag", ShaderType::FragmentShader }
+	});
+
+	// Models draw state.
+	ModelManager::Init(ResourceManager::shaderProgram);
+	GpuCuller::Init();
+	SceneRenderer::Init();
+
+	// Per-frame dynamic data, written ahead of the GPU.
+	FrameRing::Init();
+	GpuProfiler::Init();
 }
 
 void App::InitSampler()
@@ -228,6 +504,22 @@ void App::InitSampler()
 	glSamplerParameterf(m_sampler, GL_TEXTURE_MAX_ANISOTROPY_EXT, 4.f);
 }
 
+// Color and depth of headless frames, the invisible window framebuffer is never used.
+void App::InitOffscreen()
+{
+	glCreateRenderbuffers(1, &m_offscreenColor);
+	glNamedRenderbufferStorage(m_offscreenColor, GL_RGBA8, m_headless.width, m_headless.height);
+	glCreateRenderbuffers(1, &m_offscreenDepth);
+	glNamedRenderbufferStorage(m_offscreenDepth, GL_DEPTH24_STENCIL8, m_headless.width, m_headless.height);
+
+	glCreateFramebuffers(1, &m_offscreenFramebuffer);
+	glNamedFramebufferRenderbuffer(m_offscreenFramebuffer, GL_COLOR_ATTACHMENT0,        GL_RENDERBUFFER, m_offscreenColor);
+	glNamedFramebufferRenderbuffer(m_offscreenFramebuffer, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_offscreenDepth);
+
+	if (glCheckNamedFramebufferStatus(m_offscreenFramebuffer, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		throw std::runtime_error("Failed to create the headless framebuffer");
+}
+
 // ===================================================================
 // Application private loaders methods.
 // ===================================================================
@@ -235,6 +527,8 @@ void App::InitSampler()
 // Load all scenes components.
 void App::LoadScene()
 {
+	PROFILE_FUNCTION();
+
 	// Model loading.
 	ModelManager::AddModel("Box", "Assets/Meshes/box.obj", "Assets/Textures/box.png");
 	ModelManager::AddModel("Headcrab", "Assets/Meshes/headcrab.obj", "Assets/Textures/headcrab.png");
@@ -244,10 +538,14 @@ void App::LoadScene()
 	Headcrab->SetPosition({-4, 15, 4});
 	Headcrab->SetRotation({0, -0.75f, 0});
 	Headcrab->SetScale({30, 30, 30});
+	ModelManager::GetModel("Box")->SetOccluder(true);
+
+	// Loaded models are inserted one by one, build a balanced hierarchy once.
+	SceneGraph::bvh.Rebuild();
 	
 	// Lights loading.
 	LightManager::Init();
-	LightManager::SetLight(Light(Maths::Vector3(0, 0, 0), Maths::Vector3(5, 5, 5), Maths::Vector3(0.4f, 0.4f, 0.4f), Maths::Vector3(0, 0, 0), Maths::Vector3(0.5f, -1, 1)), 0);
+	LightManager::SetLight(Light(Maths::Vector3(0, 0, 0), Maths::Vector3(1, 1, 1), Maths::Vector3(1, 1, 1), Maths::Vector3(0, 0, 0), Maths::Vector3(0.5f, -1, 1)), 0);
 	
 	// Camera initialization.
 	m_camera = Camera(m_screenWidth, m_screenHeight, 90, 0.1f, 200, 40);
@@ -255,6 +553,64 @@ void App::LoadScene()
 	m_camera.SetRotation(-0.7f, 0.7f);
 }
 
+// ===================================================================
+// Application private runners methods.
+// ===================================================================
+
+// Frames are rendered on the calling thread so that each one can be read back once done.
+void App::RunHeadless()
+{
+	CameraPath path;
+	if (!m_headless.cameraPath.empty() && !path.Load(m_headless.cameraPath)) return;
+
+	unsigned int frames = m_headless.frames;
+	if      (m_replay.GetFrameCount() > 0) frames = (unsigned int)m_replay.GetFrameCount();
+	else if (!path.IsEmpty())             frames = (unsigned int)(path.GetDuration() / HEADLESS_TIMESTEP) + 1;
+	m_samples.reserve(frames);
+
+	for (unsigned int frame = 0; frame < frames; frame++)
+	{
+		path.Apply(m_camera, frame * HEADLESS_TIMESTEP);
+
+		double start = GetTime();
+		EarlyUpdate();
+		Render();
+		LateUpdate();
+		RecordSample((float)((GetTime() - start) * 1000));
+		m_replayFrame++;
+
+		if (!m_headless.outputDirectory.empty() && frame % m_headless.saveInterval == 0)
+		{
+			char name[32];
+			snprintf(name, sizeof(name), "/frame_%05u.png", frame);
+			Headless::SaveFrame(m_offscreenFramebuffer, m_headless.width, m_headless.height, m_headless.outputDirectory + name);
+		}
+	}
+
+	string size = to_string(m_headless.width) + "x" + to_string(m_headless.height);
+	ReportBenchmark((m_replay.GetFrameCount() > 0 ? "Headless benchmark at " : "Headless run at ") + size);
+}
+
+// Sample of the last published frame, its render results are filled in as they come back.
+void App::RecordSample(const float& cpuMs)
+{
+	m_samples.push_back({ m_snapshotFrame, cpuMs, -1, 0, 0 });
+	UpdateSamples(FrameQueue::renderStats.frameDraws, FrameQueue::renderStats.gpuFrameTimes);
+}
+
+// Needs the GL context: the last frames are still in flight, only dropped readbacks miss their GPU time.
+void App::ReportBenchmark(const string& name)
+{
+	FrameQueue::CopyRenderStats();
+	UpdateSamples(FrameQueue::renderStats.frameDraws, FrameQueue::renderStats.gpuFrameTimes);
+
+	GpuProfiler::Flush();
+	UpdateSamples({}, GpuProfiler::frameTimes);
+	GpuProfiler::frameTimes.clear();
+
+	Benchmark::Report(name, m_samples);
+}
+
 // ===================================================================
 // Application private updaters methods.
 // ===================================================================
@@ -317,10 +673,52 @@ void App::UpdateCursor(GLFWwindow* window, double mouseX, double mouseY, Rendere
 	}
 } 
 
-// Update GLFW window related.
-void App::UpdateWindow(GLFWwindow* window)
+// Copied by the frame queue for the main thread, the render thread keeps writing its own state.
+void App::UpdateFrameResults(const unsigned long long& frame)
 {
-	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+	m_frameResults.draws            = ModelManager::stats;
+	m_frameResults.commands         = ModelManager::commandStats;
+	m_frameResults.glState          = GLState::stats;
+	m_frameResults.frameRing        = FrameRing::stats;
+	m_frameResults.path             = SceneRenderer::renderedPath;
+	m_frameResults.deferredFailed   = SceneRenderer::deferredFailed;
+	m_frameResults.timings          = SceneRenderer::timings;
+	m_frameResults.resolutionScale  = ResolutionScaler::scale;
+	m_frameResults.sceneWidth       = ResolutionScaler::width;
+	m_frameResults.sceneHeight      = ResolutionScaler::height;
+	m_frameResults.gpuZones         = GpuProfiler::zones;
+	m_frameResults.gpuHistory       = GpuProfiler::history;
+	m_frameResults.gpuHistoryFrame  = GpuProfiler::historyFrame;
+	m_frameResults.gpuDroppedFrames = GpuProfiler::droppedFrames;
+
+	// Multi-draw calls are those the GPU received, whichever the culling path.
+	m_frameResults.frameDraws    = { { frame, ModelManager::stats.multiDraws, ModelManager::stats.triangles } };
+	m_frameResults.gpuFrameTimes = GpuProfiler::frameTimes;
+	GpuProfiler::frameTimes.clear();
+}
+
+// Draws are known once the frame is presented and GPU times a few frames later, both are matched by frame index.
+void App::UpdateSamples(const vector<FrameDrawCounts>& draws, const vector<GpuFrameTime>& gpuTimes)
+{
+	auto find = [this](const unsigned long long& frame) -> FrameSample*
+	{
+		for (size_t i = m_samples.size(); i-- > 0 && m_samples[i].frame >= frame;)
+			if (m_samples[i].frame == frame) return &m_samples[i];
+		return nullptr;
+	};
+
+	for (const FrameDrawCounts& frame : draws)
+	{
+		FrameSample* sample = find(frame.frame);
+		if (sample == nullptr) continue;
+		sample->multiDraws = frame.multiDraws;
+		sample->triangles  = frame.triangles;
+	}
+	for (const GpuFrameTime& frame : gpuTimes)
+	{
+		FrameSample* sample = find(frame.frame);
+		if (sample != nullptr) sample->gpuMs = frame.ms;
+	}
 }
 
 // ===================================================================
@@ -347,13 +745,4 @@ void processInput(GLFWwindow* window, Renderer::CameraInputs* inputs, const bool
 		inputs->forward = inputs->backward = inputs->right =
 		inputs->left    = inputs->up       = inputs->down  = false;
 	}
-}
-
-// Glfw: whenever the window size changed (by OS or user resize)
-// this callback function executes.
-void framebuffer_size_callback(GLFWwindow* window, int width, int height)
-{
-	// Make sure the viewport matches the new window dimensions; note that width and
-	// height will be significantly larger than specified on retina displays.
-	glViewport(0, 0, width, height * frameAspectRatio);
 }
\ No newline at end of file
@@ -0,0 +1,559 @@
+#include <cmath>
+#include <cfloat>
+#include <cstring>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include <Bounds.h>
+#include <FrustumCuller.h>
+#include <JobSystem.h>
+#include <BVH.h>
+
+using namespace std;
+using namespace Core::Maths;
+using namespace Core::Scene;
+using namespace Renderer;
+
+// ===================================================================
+// BVH boxes helpers.
+// ===================================================================
+
+static float GetArea(const float* min, const float* max)
+{
+	float dx = max[0] - min[0], dy = max[1] - min[1], dz = max[2] - min[2];
+	return 2 * (dx * dy + dy * dz + dz * dx);
+}
+
+static float GetArea(const BVHNode& node)
+{
+	return GetArea(node.min, node.max);
+}
+
+static float GetUnionArea(const BVHNode& a, const BVHNode& b)
+{
+	float min[3], max[3];
+	for (int i = 0; i < 3; i++)
+	{
+		min[i] = fminf(a.min[i], b.min[i]);
+		max[i] = fmaxf(a.max[i], b.max[i]);
+	}
+	return GetArea(min, max);
+}
+
+static void SetFatBox(BVHNode& node, const Bounds& bounds)
+{
+	const float center[3]  = { bounds.center.x,  bounds.center.y,  bounds.center.z  };
+	const float extents[3] = { bounds.extents.x, bounds.extents.y, bounds.extents.z };
+	for (int i = 0; i < 3; i++)
+	{
+		float extent = extents[i] * (1 + 2 * BVH_FAT_MARGIN);
+		node.min[i] = center[i] - extent;
+		node.max[i] = center[i] + extent;
+	}
+}
+
+// ===================================================================
+// BVH public methods.
+// ===================================================================
+
+int BVH::Insert(const Bounds& bounds, void* userData)
+{
+	int leaf = AllocateNode();
+	BVHNode& node = m_nodes[leaf];
+	SetFatBox(node, bounds);
+	node.left = node.right = BVH_NULL_NODE;
+	node.height   = 0;
+	node.userData = userData;
+
+	InsertLeaf(leaf);
+	m_leafCount++;
+
+	return leaf;
+}
+
+void BVH::Remove(const int& proxy)
+{
+	RemoveLeaf(proxy);
+	FreeNode(proxy);
+	m_leafCount--;
+}
+
+bool BVH::Move(const int& proxy, const Bounds& bounds)
+{
+	BVHNode& node = m_nodes[proxy];
+
+	// Keep the leaf in place while its fat box still contains it and is not much larger.
+	const float center[3]  = { bounds.center.x,  bounds.center.y,  bounds.center.z  };
+	const float extents[3] = { bounds.extents.x, bounds.extents.y, bounds.extents.z };
+	bool contained = true;
+	for (int i = 0; i < 3; i++)
+		contained &= node.min[i] <= center[i] - extents[i] && node.max[i] >= center[i] + extents[i];
+
+	BVHNode fat;
+	SetFatBox(fat, bounds);
+	if (contained && GetArea(node) <= 4 * GetArea(fat)) return false;
+
+	RemoveLeaf(proxy);
+	memcpy(node.min, fat.min, sizeof(fat.min));
+	memcpy(node.max, fat.max, sizeof(fat.max));
+	InsertLeaf(proxy);
+
+	return true;
+}
+
+void BVH::Rebuild()
+{
+	if (m_root == BVH_NULL_NODE) return;
+
+	// Gather leaves and free internal nodes, leaves keep their index as they are referenced by proxies.
+	vector<BVHBuildItem> items;
+	vector<int> stack = { m_root };
+	items.reserve(m_leafCount);
+	while (!stack.empty())
+	{
+		int index = stack.back();
+		stack.pop_back();
+
+		const BVHNode& node = m_nodes[index];
+		if (node.IsLeaf())
+		{
+			BVHBuildItem item;
+			for (int a = 0; a < 3; a++)
+			{
+				item.min[a] = node.min[a];
+				item.max[a] = node.max[a];
+				item.centroid[a] = (node.min[a] + node.max[a]) * 0.5f;
+			}
+			item.leaf = index;
+			items.push_back(item);
+			continue;
+		}
+
+		stack.push_back(m_nodes[index].left);
+		stack.push_back(m_nodes[index].right);
+		FreeNode(index);
+	}
+
+	m_root = BuildRange(items, 0, (int)items.size());
+	m_nodes[m_root].parent = BVH_NULL_NODE;
+}
+
+void BVH::Clear()
+{
+	m_nodes.clear();
+	m_root = m_freeList = BVH_NULL_NODE;
+	m_leafCount = 0;
+}
+
+CullingStats BVH::Cull(const Frustum& frustum, vector<void*>& visible) const
+{
+	CullingStats stats = { 0, 0, 0 };
+	if (m_root == BVH_NULL_NODE) return stats;
+
+	size_t firstVisible = visible.size();
+
+	if (m_leafCount < BVH_PARALLEL_LEAVES)
+		CullSubtree(m_root, frustum, visible, stats.tested);
+	else
+	{
+		// Split the top of the tree in subtrees culled as jobs, their results are appended in order.
+		vector<int> subtrees = { m_root };
+		for (bool split = true; split && subtrees.size() < BVH_PARALLEL_SUBTREES;)
+		{
+			vector<int> children;
+			split = false;
+			for (int index : subtrees)
+			{
+				if (m_nodes[index].IsLeaf()) { children.push_back(index); continue; }
+				children.push_back(m_nodes[index].left);
+				children.push_back(m_nodes[index].right);
+				split = true;
+			}
+			subtrees.swap(children);
+		}
+
+		// Kept by the calling thread, jobs write through this reference.
+		static thread_local vector<vector<void*>> subtreeResults;
+		vector<vector<void*>>& results = subtreeResults;
+		vector<unsigned int> tested(subtrees.size(), 0);
+		results.resize(max(results.size(), subtrees.size()));
+
+		Core::JobSystem::ParallelFor(subtrees.size(), 1, [&](const size_t& first, const size_t& last)
+		{
+			for (size_t i = first; i < last; i++)
+			{
+				results[i].clear();
+				CullSubtree(subtrees[i], frustum, results[i], tested[i]);
+			}
+		});
+
+		for (size_t i = 0; i < subtrees.size(); i++)
+		{
+			visible.insert(visible.end(), results[i].begin(), results[i].end());
+			stats.tested += tested[i];
+		}
+	}
+
+	stats.visible = (unsigned int)(visible.size() - firstVisible);
+	stats.culled  = m_leafCount - stats.visible;
+	return stats;
+}
+
+int BVH::GetHeight()    const { return m_root == BVH_NULL_NODE ? 0 : m_nodes[m_root].height; }
+int BVH::GetLeafCount() const { return m_leafCount; }
+const BVHNode& BVH::GetNode(const int& index) const { return m_nodes[index]; }
+
+// ===================================================================
+// BVH private methods.
+// ===================================================================
+
+// Walk a subtree against the frustum, planes are tested from its root.
+void BVH::CullSubtree(const int& root, const Frustum& frustum, vector<void*>& visible, unsigned int& tested) const
+{
+	// Each entry carries the planes its parent box was not already fully inside.
+	static thread_local vector<pair<int, unsigned int>> stack;
+	stack.clear();
+	stack.push_back({ root, 0x3F });
+
+	while (!stack.empty())
+	{
+		auto [index, mask] = stack.back();
+		stack.pop_back();
+
+		const BVHNode& node = m_nodes[index];
+		tested++;
+
+		bool outside = false;
+		for (int p = 0; p < 6 && !outside; p++)
+		{
+			if (!(mask & (1 << p))) continue;
+
+			const float* plane = frustum.planes[p];
+			float dist = plane[3], radius = 0;
+			for (int i = 0; i < 3; i++)
+			{
+				dist   += plane[i] * (node.min[i] + node.max[i]) * 0.5f;
+				radius += fabsf(plane[i]) * (node.max[i] - node.min[i]) * 0.5f;
+			}
+
+			if      (dist + radius < 0)  outside = true;
+			else if (dist - radius >= 0) mask &= ~(1 << p);
+		}
+		if (outside) continue;
+
+		if (node.IsLeaf())        visible.push_back(node.userData);
+		else if (mask == 0)       AppendLeaves(index, visible);
+		else
+		{
+			stack.push_back({ node.left,  mask });
+			stack.push_back({ node.right, mask });
+		}
+	}
+}
+
+int BVH::AllocateNode()
+{
+	if (m_freeList == BVH_NULL_NODE)
+	{
+		m_nodes.push_back(BVHNode());
+		m_freeList = (int)m_nodes.size() - 1;
+		m_nodes[m_freeList].parent = BVH_NULL_NODE;
+	}
+
+	int index = m_freeList;
+	m_freeList = m_nodes[index].parent;
+
+	BVHNode& node = m_nodes[index];
+	node.parent = node.left = node.right = BVH_NULL_NODE;
+	node.height   = 0;
+	node.userData = nullptr;
+
+	return index;
+}
+
+void BVH::FreeNode(const int& index)
+{
+	m_nodes[index].parent = m_freeList;
+	m_nodes[index].height = -1;
+	m_freeList = index;
+}
+
+// Descend towards the sibling minimizing the added surface area, then pair the leaf with it.
+void BVH::InsertLeaf(const int& leaf)
+{
+	if (m_root == BVH_NULL_NODE)
+	{
+		m_root = leaf;
+		m_nodes[leaf].parent = BVH_NULL_NODE;
+		return;
+	}
+
+	int index = m_root;
+	while (!m_nodes[index].IsLeaf())
+	{
+		const BVHNode& node = m_nodes[index];
+		const BVHNode& newLeaf = m_nodes[leaf];
+
+		float area         = GetArea(node);
+		float combinedArea = GetUnionArea(node, newLeaf);
+
+		// Cost of pairing with this node, and minimum cost inherited by going further down.
+		float cost        = 2 * combinedArea;
+		float inheritance = 2 * (combinedArea - area);
+
+		auto childCost = [&](const int& child)
+		{
+			const BVHNode& childNode = m_nodes[child];
+			float childArea = GetUnionArea(childNode, newLeaf);
+			return (childNode.IsLeaf() ? childArea : childArea - GetArea(childNode)) + inheritance;
+		};
+
+		float costLeft  = childCost(node.left);
+		float costRight = childCost(node.right);
+		if (cost < costLeft && cost < costRight) break;
+
+		index = costLeft < costRight ? node.left : node.right;
+	}
+
+	int sibling   = index;
+	int oldParent = m_nodes[sibling].parent;
+	int newParent = AllocateNode();
+
+	BVHNode& parent = m_nodes[newParent];
+	parent.parent = oldParent;
+	parent.left   = sibling;
+	parent.right  = leaf;
+	m_nodes[sibling].parent = newParent;
+	m_nodes[leaf].parent    = newParent;
+
+	if (oldParent == BVH_NULL_NODE) m_root = newParent;
+	else if (m_nodes[oldParent].left == sibling) m_nodes[oldParent].left  = newParent;
+	else                                          m_nodes[oldParent].right = newParent;
+
+	Refit(newParent);
+}
+
+// Replace the leaf parent by its sibling.
+void BVH::RemoveLeaf(const int& leaf)
+{
+	if (leaf == m_root)
+	{
+		m_root = BVH_NULL_NODE;
+		return;
+	}
+
+	int parent      = m_nodes[leaf].parent;
+	int grandParent = m_nodes[parent].parent;
+	int sibling     = m_nodes[parent].left == leaf ? m_nodes[parent].right : m_nodes[parent].left;
+
+	m_nodes[sibling].parent = grandParent;
+	FreeNode(parent);
+
+	if (grandParent == BVH_NULL_NODE)
+	{
+		m_root = sibling;
+		return;
+	}
+
+	if (m_nodes[grandParent].left == parent) m_nodes[grandParent].left  = sibling;
+	else                                     m_nodes[grandParent].right = sibling;
+
+	Refit(grandParent);
+}
+
+// Recompute boxes and heights up to the root, rotating each ancestor.
+void BVH::Refit(int index)
+{
+	while (index != BVH_NULL_NODE)
+	{
+		BVHNode& node = m_nodes[index];
+		const BVHNode& left  = m_nodes[node.left];
+		const BVHNode& right = m_nodes[node.right];
+
+		for (int i = 0; i < 3; i++)
+		{
+			node.min[i] = fminf(left.min[i], right.min[i]);
+			node.max[i] = fmaxf(left.max[i], right.max[i]);
+		}
+		node.height = 1 + max(left.height, right.height);
+
+		Rotate(index);
+		index = node.parent;
+	}
+}
+
+// Swap a child with a grandchild on the other side when it reduces the surface area of the changed child.
+void BVH::Rotate(const int& index)
+{
+	BVHNode& node = m_nodes[index];
+	if (node.height < 2) return;
+
+	int b = node.left, c = node.right;
+	float bestGain = 0;
+	int   child = BVH_NULL_NODE, grandChild = BVH_NULL_NODE;
+
+	auto consider = [&](const int& swapped, const int& other, const int& kept, const int& grand)
+	{
+		float gain = GetArea(m_nodes[other]) - GetUnionArea(m_nodes[swapped], m_nodes[kept]);
+		if (gain > bestGain)
+		{
+			bestGain   = gain;
+			child      = swapped;
+			grandChild = grand;
+		}
+	};
+
+	if (!m_nodes[c].IsLeaf())
+	{
+		consider(b, c, m_nodes[c].right, m_nodes[c].left);
+		consider(b, c, m_nodes[c].left,  m_nodes[c].right);
+	}
+	if (!m_nodes[b].IsLeaf())
+	{
+		consider(c, b, m_nodes[b].right, m_nodes[b].left);
+		consider(c, b, m_nodes[b].left,  m_nodes[b].right);
+	}
+
+	if (child == BVH_NULL_NODE) return;
+
+	// The child moves under the other child, in place of the grandchild.
+	int other = m_nodes[grandChild].parent;
+	BVHNode& otherNode = m_nodes[other];
+
+	if (node.left == child) node.left  = grandChild;
+	else                    node.right = grandChild;
+	if (otherNode.left == grandChild) otherNode.left  = child;
+	else                              otherNode.right = child;
+
+	m_nodes[grandChild].parent = index;
+	m_nodes[child].parent      = other;
+
+	const BVHNode& left  = m_nodes[otherNode.left];
+	const BVHNode& right = m_nodes[otherNode.right];
+	for (int i = 0; i < 3; i++)
+	{
+		otherNode.min[i] = fminf(left.min[i], right.min[i]);
+		otherNode.max[i] = fmaxf(left.max[i], right.max[i]);
+	}
+	otherNode.height = 1 + max(left.height, right.height);
+	node.height = 1 + max(m_nodes[node.left].height, m_nodes[node.right].height);
+}
+
+// Binned SAH split on the largest axis of the leaves centroids.
+int BVH::BuildRange(vector<BVHBuildItem>& items, const int& begin, const int& end)
+{
+	if (end - begin == 1) return items[begin].leaf;
+
+	float cmin[3] = { FLT_MAX, FLT_MAX, FLT_MAX }, cmax[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	for (int i = begin; i < end; i++)
+	{
+		for (int a = 0; a < 3; a++)
+		{
+			cmin[a] = fminf(cmin[a], items[i].centroid[a]);
+			cmax[a] = fmaxf(cmax[a], items[i].centroid[a]);
+		}
+	}
+
+	int axis = 0;
+	for (int a = 1; a < 3; a++)
+		if (cmax[a] - cmin[a] > cmax[axis] - cmin[axis]) axis = a;
+
+	float extent = cmax[axis] - cmin[axis];
+	int mid = (begin + end) / 2;
+
+	if (extent > 0)
+	{
+		struct Bin { int count = 0; float min[3] = { FLT_MAX, FLT_MAX, FLT_MAX }, max[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX }; };
+		Bin bins[BVH_SAH_BINS];
+		float binScale = BVH_SAH_BINS / extent;
+		auto binIndex = [&](const BVHBuildItem& item) { return min((int)((item.centroid[axis] - cmin[axis]) * binScale), BVH_SAH_BINS - 1); };
+
+		for (int i = begin; i < end; i++)
+		{
+			Bin& bin = bins[binIndex(items[i])];
+			bin.count++;
+			for (int a = 0; a < 3; a++)
+			{
+				bin.min[a] = fminf(bin.min[a], items[i].min[a]);
+				bin.max[a] = fmaxf(bin.max[a], items[i].max[a]);
+			}
+		}
+
+		// Sweep from the right to get the cost of each right part, then from the left to find the cheapest split.
+		float rightCost[BVH_SAH_BINS];
+		Bin accumulated;
+		for (int b = BVH_SAH_BINS - 1; b > 0; b--)
+		{
+			accumulated.count += bins[b].count;
+			for (int a = 0; a < 3; a++)
+			{
+				accumulated.min[a] = fminf(accumulated.min[a], bins[b].min[a]);
+				accumulated.max[a] = fmaxf(accumulated.max[a], bins[b].max[a]);
+			}
+			rightCost[b] = accumulated.count ? accumulated.count * GetArea(accumulated.min, accumulated.max) : 0;
+		}
+
+		float bestCost = FLT_MAX;
+		int   bestSplit = BVH_NULL_NODE;
+		accumulated = Bin();
+		for (int b = 1; b < BVH_SAH_BINS; b++)
+		{
+			accumulated.count += bins[b - 1].count;
+			for (int a = 0; a < 3; a++)
+			{
+				accumulated.min[a] = fminf(accumulated.min[a], bins[b - 1].min[a]);
+				accumulated.max[a] = fmaxf(accumulated.max[a], bins[b - 1].max[a]);
+			}
+
+			float cost = (accumulated.count ? accumulated.count * GetArea(accumulated.min, accumulated.max) : 0) + rightCost[b];
+			if (accumulated.count > 0 && accumulated.count < end - begin && cost < bestCost)
+			{
+				bestCost  = cost;
+				bestSplit = b;
+			}
+		}
+
+		if (bestSplit != BVH_NULL_NODE)
+			mid = (int)(partition(items.begin() + begin, items.begin() + end, [&](const BVHBuildItem& item) { return binIndex(item) < bestSplit; }) - items.begin());
+	}
+
+	int left  = BuildRange(items, begin, mid);
+	int right = BuildRange(items, mid, end);
+
+	int index = AllocateNode();
+	BVHNode& node = m_nodes[index];
+	node.left  = left;
+	node.right = right;
+	m_nodes[left].parent = m_nodes[right].parent = index;
+
+	for (int a = 0; a < 3; a++)
+	{
+		node.min[a] = fminf(m_nodes[left].min[a], m_nodes[right].min[a]);
+		node.max[a] = fmaxf(m_nodes[left].max[a], m_nodes[right].max[a]);
+	}
+	node.height = 1 + max(m_nodes[left].height, m_nodes[right].height);
+
+	return index;
+}
+
+// Append every leaf of a subtree without testing it.
+void BVH::AppendLeaves(const int& index, vector<void*>& out) const
+{
+	static thread_local vector<int> stack;
+	stack.clear();
+	stack.push_back(index);
+
+	while (!stack.empty())
+	{
+		const BVHNode& node = m_nodes[stack.back()];
+		stack.pop_back();
+
+		if (node.IsLeaf()) out.push_back(node.userData);
+		else
+		{
+			stack.push_back(node.left);
+			stack.push_back(node.right);
+		}
+	}
+}
\ No newline at end of file
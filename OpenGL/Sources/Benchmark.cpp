@@ -0,0 +1,68 @@
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <Debug.h>
+#include <Benchmark.h>
+
+using namespace std;
+using namespace Core::Debug;
+
+// ===================================================================
+// FrameTimeStats public methods.
+// ===================================================================
+
+FrameTimeStats FrameTimeStats::Compute(vector<float> times)
+{
+	if (times.empty()) return { 0, 0, 0, 0, 0, 0 };
+
+	sort(times.begin(), times.end());
+	auto percentile = [&](const float& p) { return times[min(times.size() - 1, (size_t)(p * times.size()))]; };
+
+	double sum = 0;
+	for (float time : times) sum += time;
+
+	return { (float)(sum / times.size()), percentile(0.5f), percentile(0.95f), percentile(0.99f), times.front(), times.back() };
+}
+
+// ===================================================================
+// Benchmark public methods.
+// ===================================================================
+
+void Benchmark::Report(const string& name, const vector<FrameSample>& samples)
+{
+	vector<float> cpuTimes, gpuTimes;
+	double multiDraws = 0, triangles = 0;
+	unsigned int maxMultiDraws = 0, maxTriangles = 0;
+	for (const FrameSample& sample : samples)
+	{
+		cpuTimes.push_back(sample.cpuMs);
+		if (sample.gpuMs >= 0) gpuTimes.push_back(sample.gpuMs);
+
+		multiDraws += sample.multiDraws;
+		triangles  += sample.triangles;
+		maxMultiDraws = max(maxMultiDraws, sample.multiDraws);
+		maxTriangles = max(maxTriangles, sample.triangles);
+	}
+
+	FrameTimeStats cpu = FrameTimeStats::Compute(cpuTimes);
+	FrameTimeStats gpu = FrameTimeStats::Compute(gpuTimes);
+	size_t count = max((size_t)1, samples.size());
+
+	auto format = [](const FrameTimeStats& stats)
+	{
+		ostringstream output;
+		output.setf(ios::fixed);
+		output.precision(3);
+		output << "avg " << stats.average << " ms, p50 " << stats.p50 << ", p95 " << stats.p95 << ", p99 " << stats.p99
+			   << ", best " << stats.best << ", worst " << stats.worst;
+		return output.str();
+	};
+
+	Log(LogType::INFO, name + " of " + to_string(samples.size()) + " frames, " + to_string(cpu.average > 0 ? 1000 / cpu.average : 0) + " FPS.");
+	Log(LogType::INFO, "CPU frame: " + format(cpu) + ".");
+	Log(LogType::INFO, "GPU frame: " + format(gpu) + " (" + to_string(gpuTimes.size()) + " frames read back).");
+	Log(LogType::INFO, "Multi-draw calls: avg " + to_string((unsigned int)(multiDraws / count)) + ", max " + to_string(maxMultiDraws) + ". "
+					   "Triangles: avg " + to_string((unsigned int)(triangles / count)) + ", max " + to_string(maxTriangles) + ".");
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#include <cmath>
+#include <algorithm>
+
+#include <Vector3.h>
+#include <Matrix.h>
+#include <Bounds.h>
+
+using namespace std;
+using namespace Core::Maths;
+
+// ===================================================================
+// Bounds public methods.
+// ===================================================================
+
+Bounds Bounds::GetTransformed(const Matrix4& mat) const
+{
+	Bounds out;
+
+	// Transform the center as a point.
+	out.center = Vector3(center.x * mat.m[0][0] + center.y * mat.m[1][0] + center.z * mat.m[2][0] + mat.m[3][0],
+						 center.x * mat.m[0][1] + center.y * mat.m[1][1] + center.z * mat.m[2][1] + mat.m[3][1],
+						 center.x * mat.m[0][2] + center.y * mat.m[1][2] + center.z * mat.m[2][2] + mat.m[3][2]);
+
+	// Box extents along the world axes (absolute values of the linear part).
+	out.extents = Vector3(extents.x * fabsf(mat.m[0][0]) + extents.y * fabsf(mat.m[1][0]) + extents.z * fabsf(mat.m[2][0]),
+						  extents.x * fabsf(mat.m[0][1]) + extents.y * fabsf(mat.m[1][1]) + extents.z * fabsf(mat.m[2][1]),
+						  extents.x * fabsf(mat.m[0][2]) + extents.y * fabsf(mat.m[1][2]) + extents.z * fabsf(mat.m[2][2]));
+
+	// Sphere radius scaled by the largest axis scale.
+	float scaleX = mat.m[0][0] * mat.m[0][0] + mat.m[0][1] * mat.m[0][1] + mat.m[0][2] * mat.m[0][2];
+	float scaleY = mat.m[1][0] * mat.m[1][0] + mat.m[1][1] * mat.m[1][1] + mat.m[1][2] * mat.m[1][2];
+	float scaleZ = mat.m[2][0] * mat.m[2][0] + mat.m[2][1] * mat.m[2][1] + mat.m[2][2] * mat.m[2][2];
+	out.radius = radius * sqrtf(max(scaleX, max(scaleY, scaleZ)));
+
+	return out;
+}
\ No newline at end of file
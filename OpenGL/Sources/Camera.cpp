@@ -116,9 +116,6 @@ void Camera::Update(GLFWwindow* window, const float& deltaTime, CameraInputs* in
                    +  GetSphericalCoords(m_speed, PI / 2, 2 * PI - m_pitch - PI / 2) * m_direction.z;
         m_position.y += m_direction.y * m_speed;
     }
-
-    // Bind camera position to fragment shader.
-	glUniform3fv(glGetUniformLocation(ResourceManager::shaderProgram, "viewPos"), 1, &m_position.x);
 }
 
 // ===================================================================
@@ -0,0 +1,132 @@
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <Debug.h>
+#include <Vector3.h>
+#include <Camera.h>
+#include <CameraRecording.h>
+
+using namespace std;
+using namespace Core;
+using namespace Core::Debug;
+using namespace Renderer;
+
+// Camera recording static declaration.
+bool CameraRecording::recording = false;
+
+// ===================================================================
+// CameraRecording public methods.
+// ===================================================================
+
+void CameraRecording::Add(const Camera& camera)
+{
+	const CameraInputs& inputs = camera.inputs;
+
+	CameraFrame frame;
+	frame.position = camera.GetPosition();
+	frame.pitch    = camera.GetPitch();
+	frame.yaw      = camera.GetYaw();
+	frame.deltaX   = (float)inputs.deltaX;
+	frame.deltaY   = (float)inputs.deltaY;
+	frame.keys     = (uint8_t)(inputs.backward << 0 | inputs.forward << 1 | inputs.right << 2 |
+							   inputs.left     << 3 | inputs.up      << 4 | inputs.down  << 5);
+	m_frames.push_back(frame);
+}
+
+// The recorded state is restored as is, so replays do not depend on the frame times.
+void CameraRecording::Apply(const size_t& frame, Camera& camera) const
+{
+	if (m_frames.empty()) return;
+
+	const CameraFrame& recorded = m_frames[frame < m_frames.size() ? frame : m_frames.size() - 1];
+	camera.SetPosition(recorded.position);
+	camera.SetRotation(recorded.pitch, recorded.yaw);
+
+	CameraInputs& inputs = camera.inputs;
+	inputs.deltaX   = recorded.deltaX;
+	inputs.deltaY   = recorded.deltaY;
+	inputs.backward = recorded.keys & (1 << 0);
+	inputs.forward  = recorded.keys & (1 << 1);
+	inputs.right    = recorded.keys & (1 << 2);
+	inputs.left     = recorded.keys & (1 << 3);
+	inputs.up       = recorded.keys & (1 << 4);
+	inputs.down     = recorded.keys & (1 << 5);
+}
+
+void CameraRecording::Clear() { m_frames.clear(); }
+
+// Header of magic, version and frame count, then the packed frames.
+bool CameraRecording::Save(const string& path) const
+{
+	ofstream file(path, ios::binary);
+	if (!file.is_open())
+	{
+		Log(LogType::ERROR, "Could not write camera recording to " + path + ".");
+		return false;
+	}
+
+	uint32_t header[3] = { CAMERA_RECORDING_MAGIC, CAMERA_RECORDING_VERSION, (uint32_t)m_frames.size() };
+	file.write((const char*)header, sizeof(header));
+	for (const CameraFrame& frame : m_frames)
+	{
+		float values[7] = { frame.position.x, frame.position.y, frame.position.z, frame.pitch, frame.yaw, frame.deltaX, frame.deltaY };
+		file.write((const char*)values, sizeof(values));
+		file.write((const char*)&frame.keys, sizeof(frame.keys));
+	}
+
+	Log(LogType::INFO, "Camera recording of " + to_string(m_frames.size()) + " frames written to " + path + ".");
+	return true;
+}
+
+bool CameraRecording::Load(const string& path)
+{
+	ifstream file(path, ios::binary);
+	if (!file.is_open())
+	{
+		Log(LogType::ERROR, "Could not open camera recording " + path + ".");
+		return false;
+	}
+
+	uint32_t header[3] = {};
+	file.read((char*)header, sizeof(header));
+	if (!file || header[0] != CAMERA_RECORDING_MAGIC || header[1] != CAMERA_RECORDING_VERSION)
+	{
+		Log(LogType::ERROR, path + " is not a camera recording of version " + to_string(CAMERA_RECORDING_VERSION) + ".");
+		return false;
+	}
+
+	// The frame count is only trusted when the file holds that many frames.
+	streamoff start = file.tellg();
+	file.seekg(0, ios::end);
+	streamoff remaining = file.tellg() - start;
+	file.seekg(start);
+	if ((uint64_t)header[2] * CAMERA_RECORDING_FRAME > (uint64_t)remaining)
+	{
+		Log(LogType::ERROR, path + " is truncated: " + to_string(header[2]) + " frames announced.");
+		return false;
+	}
+
+	m_frames.resize(header[2]);
+	for (CameraFrame& frame : m_frames)
+	{
+		float values[7];
+		file.read((char*)values, sizeof(values));
+		file.read((char*)&frame.keys, sizeof(frame.keys));
+
+		frame.position = Core::Maths::Vector3(values[0], values[1], values[2]);
+		frame.pitch  = values[3]; frame.yaw    = values[4];
+		frame.deltaX = values[5]; frame.deltaY = values[6];
+	}
+
+	if (!file)
+	{
+		Log(LogType::ERROR, "Camera recording " + path + " is truncated.");
+		m_frames.clear();
+		return false;
+	}
+	return true;
+}
+
+size_t CameraRecording::GetFrameCount() const { return m_frames.size(); }
\ No newline at end of file
@@ -0,0 +1,251 @@
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <Debug.h>
+#include <GLState.h>
+#include <CommandBuffer.h>
+
+using namespace std;
+using namespace Core::Debug;
+using namespace Renderer;
+
+// Packet size of each command type, padded to the packets alignment.
+static constexpr size_t PacketSize(const size_t& size) { return (size + COMMAND_ALIGNMENT - 1) & ~(size_t)(COMMAND_ALIGNMENT - 1); }
+
+static const size_t packetSizes[(size_t)CommandType::Count] =
+{
+	PacketSize(sizeof(BindProgramCommand)),
+	PacketSize(sizeof(BindVertexArrayCommand)),
+	PacketSize(sizeof(BindVertexBufferCommand)),
+	PacketSize(sizeof(BindBufferRangeCommand)),
+	PacketSize(sizeof(BindIndirectBufferCommand)),
+	PacketSize(sizeof(BindTextureCommand)),
+	PacketSize(sizeof(BindSamplerCommand)),
+	PacketSize(sizeof(DrawIndirectCommand)),
+};
+
+// ===================================================================
+// CommandBuffer public methods.
+// ===================================================================
+
+void CommandBuffer::Reset()
+{
+	m_size = 0;
+}
+
+void CommandBuffer::Append(const CommandBuffer& other)
+{
+	if (other.m_size == 0) return;
+
+	if (m_size + other.m_size > m_data.size()) m_data.resize(max(m_data.size() * 2, m_size + other.m_size));
+	memcpy(m_data.data() + m_size, other.m_data.data(), other.m_size);
+	m_size += other.m_size;
+}
+
+void CommandBuffer::BindProgram(const GLuint& program)
+{
+	Push<BindProgramCommand>(CommandType::BindProgram)->program = program;
+}
+
+void CommandBuffer::BindVertexArray(const GLuint& vertexArray)
+{
+	Push<BindVertexArrayCommand>(CommandType::BindVertexArray)->vertexArray = vertexArray;
+}
+
+void CommandBuffer::BindVertexBuffer(const GLuint& vertexArray, const GLuint& index, const GLuint& buffer, const GLintptr& offset, const GLuint& stride)
+{
+	BindVertexBufferCommand* command = Push<BindVertexBufferCommand>(CommandType::BindVertexBuffer);
+	command->vertexArray = vertexArray;
+	command->index       = index;
+	command->buffer      = buffer;
+	command->stride      = stride;
+	command->offset      = offset;
+}
+
+void CommandBuffer::BindBufferRange(const GLenum& target, const GLuint& index, const GLuint& buffer, const GLintptr& offset, const GLsizeiptr& size)
+{
+	BindBufferRangeCommand* command = Push<BindBufferRangeCommand>(CommandType::BindBufferRange);
+	command->target = target;
+	command->index  = index;
+	command->buffer = buffer;
+	command->offset = offset;
+	command->size   = size;
+}
+
+void CommandBuffer::BindIndirectBuffer(const GLuint& buffer)
+{
+	Push<BindIndirectBufferCommand>(CommandType::BindIndirectBuffer)->buffer = buffer;
+}
+
+void CommandBuffer::BindTexture(const GLuint& unit, const GLuint& texture)
+{
+	BindTextureCommand* command = Push<BindTextureCommand>(CommandType::BindTexture);
+	command->unit    = unit;
+	command->texture = texture;
+}
+
+void CommandBuffer::BindSampler(const GLuint& unit, const GLuint& sampler)
+{
+	BindSamplerCommand* command = Push<BindSamplerCommand>(CommandType::BindSampler);
+	command->unit    = unit;
+	command->sampler = sampler;
+}
+
+void CommandBuffer::DrawIndirect(const GLintptr& offset, const GLsizei& drawCount)
+{
+	DrawIndirectCommand* command = Push<DrawIndirectCommand>(CommandType::DrawIndirect);
+	command->drawCount = drawCount;
+	command->offset    = offset;
+}
+
+// Walk the packets as Execute would, tracking the states a draw needs.
+bool CommandBuffer::Validate() const
+{
+	GLuint program = 0, vertexArray = 0, indirectBuffer = 0;
+
+	for (size_t offset = 0; offset < m_size;)
+	{
+		const CommandHeader* header = (const CommandHeader*)(m_data.data() + offset);
+		string error;
+
+		if (offset + sizeof(CommandHeader) > m_size || (size_t)header->type >= (size_t)CommandType::Count)
+			error = "unknown command type";
+		else if (header->size != packetSizes[(size_t)header->type] || offset + header->size > m_size)
+			error = string("bad size of ") + GetTypeName(header->type);
+		else switch (header->type)
+		{
+		case CommandType::BindProgram:        program        = ((const BindProgramCommand*)header)->program;            break;
+		case CommandType::BindVertexArray:    vertexArray    = ((const BindVertexArrayCommand*)header)->vertexArray;    break;
+		case CommandType::BindIndirectBuffer: indirectBuffer = ((const BindIndirectBufferCommand*)header)->buffer;      break;
+		case CommandType::BindVertexBuffer:
+			if (((const BindVertexBufferCommand*)header)->vertexArray == 0) error = "vertex buffer bound to no vertex array";
+			break;
+		case CommandType::BindBufferRange:
+			if (((const BindBufferRangeCommand*)header)->size <= 0) error = "empty buffer range";
+			break;
+		case CommandType::DrawIndirect:
+		{
+			const DrawIndirectCommand* draw = (const DrawIndirectCommand*)header;
+			if      (program == 0)        error = "draw without program";
+			else if (vertexArray == 0)    error = "draw without vertex array";
+			else if (indirectBuffer == 0) error = "draw without indirect buffer";
+			else if (draw->drawCount <= 0 || draw->offset % sizeof(GLuint) != 0) error = "bad indirect draw range";
+			break;
+		}
+		default: break;
+		}
+
+		if (!error.empty())
+		{
+			Log(LogType::ERROR, "Invalid command buffer at byte " + to_string(offset) + ": " + error + ".");
+			return false;
+		}
+
+		offset += header->size;
+	}
+
+	return true;
+}
+
+void CommandBuffer::Execute(CommandStats& stats) const
+{
+	stats.bytes += m_size;
+
+	for (size_t offset = 0; offset < m_size;)
+	{
+		const CommandHeader* header = (const CommandHeader*)(m_data.data() + offset);
+		stats.counts[(size_t)header->type]++;
+		stats.packets++;
+
+		switch (header->type)
+		{
+		case CommandType::BindProgram:
+			GLState::UseProgram(((const BindProgramCommand*)header)->program);
+			break;
+
+		case CommandType::BindVertexArray:
+			GLState::BindVertexArray(((const BindVertexArrayCommand*)header)->vertexArray);
+			break;
+
+		case CommandType::BindVertexBuffer:
+		{
+			const BindVertexBufferCommand* command = (const BindVertexBufferCommand*)header;
+			glVertexArrayVertexBuffer(command->vertexArray, command->index, command->buffer, command->offset, command->stride);
+			break;
+		}
+
+		case CommandType::BindBufferRange:
+		{
+			const BindBufferRangeCommand* command = (const BindBufferRangeCommand*)header;
+			GLState::BindBufferRange(command->target, command->index, command->buffer, command->offset, command->size);
+			break;
+		}
+
+		case CommandType::BindIndirectBuffer:
+			GLState::BindBuffer(GL_DRAW_INDIRECT_BUFFER, ((const BindIndirectBufferCommand*)header)->buffer);
+			break;
+
+		case CommandType::BindTexture:
+		{
+			const BindTextureCommand* command = (const BindTextureCommand*)header;
+			GLState::BindTextureUnit(command->unit, command->texture);
+			break;
+		}
+
+		case CommandType::BindSampler:
+		{
+			const BindSamplerCommand* command = (const BindSamplerCommand*)header;
+			GLState::BindSampler(command->unit, command->sampler);
+			break;
+		}
+
+		case CommandType::DrawIndirect:
+		{
+			const DrawIndirectCommand* command = (const DrawIndirectCommand*)header;
+			glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)command->offset, command->drawCount, 0);
+			break;
+		}
+
+		default: break;
+		}
+
+		offset += header->size;
+	}
+}
+
+const char* CommandBuffer::GetTypeName(const CommandType& type)
+{
+	switch (type)
+	{
+	case CommandType::BindProgram:        return "Bind program";
+	case CommandType::BindVertexArray:    return "Bind vertex array";
+	case CommandType::BindVertexBuffer:   return "Bind vertex buffer";
+	case CommandType::BindBufferRange:    return "Bind buffer range";
+	case CommandType::BindIndirectBuffer: return "Bind indirect buffer";
+	case CommandType::BindTexture:        return "Bind texture";
+	case CommandType::BindSampler:        return "Bind sampler";
+	case CommandType::DrawIndirect:       return "Multi-draw indirect";
+	default:                              return "Unknown";
+	}
+}
+
+// ===================================================================
+// CommandBuffer private methods.
+// ===================================================================
+
+// Allocate the next packet at the head, growing the storage geometrically.
+template<typename T> T* CommandBuffer::Push(const CommandType& type)
+{
+	const size_t size = PacketSize(sizeof(T));
+	if (m_size + size > m_data.size()) m_data.resize(max({ m_data.size() * 2, m_size + size, (size_t)256 }));
+
+	T* packet = (T*)(m_data.data() + m_size);
+	memset(packet, 0, size);
+	packet->header = { type, (uint16_t)size };
+	m_size += size;
+	return packet;
+}
\ No newline at end of file
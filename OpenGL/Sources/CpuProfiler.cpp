@@ -0,0 +1,173 @@
+#ifdef ENABLE_PROFILER
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Debug.h>
+#include <CpuProfiler.h>
+
+using namespace std;
+using namespace Core::Debug;
+
+// CPU profiler static declaration.
+bool                              CpuProfiler::exportRequested = false;
+atomic<ProfileThreadBuffer*>      CpuProfiler::buffers         = nullptr;
+atomic<unsigned int>              CpuProfiler::threadCount     = 0;
+thread_local ProfileThreadBuffer* CpuProfiler::threadBuffer    = nullptr;
+
+// Trace origin, ticks are converted to microseconds against the steady clock elapsed since.
+static const uint64_t                      originTicks = CpuProfiler::Now();
+static const chrono::steady_clock::time_point originTime = chrono::steady_clock::now();
+
+// Chrome trace strings, file paths hold backslashes on Windows.
+static string Escape(const char* text)
+{
+	string escaped;
+	for (; *text != '\0'; text++)
+	{
+		if (*text == '"' || *text == '\\') escaped += '\\';
+		escaped += *text;
+	}
+	return escaped;
+}
+
+// ===================================================================
+// CpuProfiler public methods.
+// ===================================================================
+
+// Named before its buffer is published when called first on the thread.
+void CpuProfiler::SetThreadName(const string& name)
+{
+	if (threadBuffer == nullptr) Register(name);
+	else snprintf(threadBuffer->name, sizeof(threadBuffer->name), "%s", name.c_str());
+}
+
+void CpuProfiler::Record(const ProfileSource* source, const uint64_t& begin, const uint64_t& end)
+{
+	ProfileThreadBuffer* buffer = GetThreadBuffer();
+
+	uint64_t index = buffer->written.load(memory_order_relaxed);
+	ProfileSlot& slot = buffer->events[index & (CPU_PROFILER_EVENTS - 1)];
+	slot.source.store(source, memory_order_relaxed);
+	slot.begin .store(begin,  memory_order_relaxed);
+	slot.end   .store(end,    memory_order_relaxed);
+	buffer->written.store(index + 1, memory_order_release);
+}
+
+// One complete event per zone and the name of each thread, timestamps in microseconds.
+bool CpuProfiler::ExportTrace(const string& path)
+{
+	ofstream file(path);
+	if (!file.is_open())
+	{
+		Log(LogType::ERROR, "Could not write CPU trace to " + path + ".");
+		return false;
+	}
+
+	double ticksPerUs = GetTicksPerMicrosecond();
+	size_t eventCount = 0;
+	vector<ProfileEvent> events;
+
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	file.setf(ios::fixed);
+	file.precision(3);
+
+	bool first = true;
+	for (ProfileThreadBuffer* buffer = buffers.load(memory_order_acquire); buffer != nullptr; buffer = buffer->next)
+	{
+		// Copy the ring, then drop the events its owner may have overwritten during the copy.
+		uint64_t written = buffer->written.load(memory_order_acquire);
+		uint64_t start   = written > CPU_PROFILER_EVENTS ? written - CPU_PROFILER_EVENTS : 0;
+
+		events.clear();
+		for (uint64_t i = start; i < written; i++)
+		{
+			const ProfileSlot& slot = buffer->events[i & (CPU_PROFILER_EVENTS - 1)];
+			events.push_back({ slot.source.load(memory_order_relaxed), slot.begin.load(memory_order_relaxed), slot.end.load(memory_order_relaxed) });
+		}
+		atomic_thread_fence(memory_order_acquire);
+
+		uint64_t overwritten = buffer->written.load(memory_order_acquire);
+		size_t   skipped     = overwritten > CPU_PROFILER_EVENTS + start ? (size_t)(overwritten - CPU_PROFILER_EVENTS - start) : 0;
+
+		file << (first ? "" : ",\n")
+			 << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id
+			 << ",\"args\":{\"name\":\"" << Escape(buffer->name[0] != '\0' ? buffer->name : "Thread") << "\"}},\n"
+			 << "{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id
+			 << ",\"args\":{\"sort_index\":" << buffer->id << "}}";
+		first = false;
+
+		for (size_t i = min(skipped, events.size()); i < events.size(); i++)
+		{
+			const ProfileEvent& event = events[i];
+			double begin = ((double)event.begin - (double)originTicks) / ticksPerUs;
+			double end   = ((double)event.end   - (double)originTicks) / ticksPerUs;
+
+			file << ",\n{\"name\":\"" << Escape(event.source->name) << "\",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->id
+				 << ",\"ts\":" << begin << ",\"dur\":" << (end - begin)
+				 << ",\"args\":{\"function\":\"" << Escape(event.source->function)
+				 << "\",\"file\":\"" << Escape(event.source->file) << "\",\"line\":" << event.source->line << "}}";
+			eventCount++;
+		}
+	}
+
+	file << "\n]}\n";
+
+	Log(LogType::INFO, "CPU trace of " + to_string(eventCount) + " zones written to " + path + ".");
+	return true;
+}
+
+void CpuProfiler::Unload()
+{
+	ProfileThreadBuffer* buffer = buffers.exchange(nullptr);
+	while (buffer != nullptr)
+	{
+		ProfileThreadBuffer* next = buffer->next;
+		delete buffer;
+		buffer = next;
+	}
+	threadBuffer = nullptr;
+}
+
+// ===================================================================
+// CpuProfiler private methods.
+// ===================================================================
+
+ProfileThreadBuffer* CpuProfiler::GetThreadBuffer()
+{
+	return threadBuffer != nullptr ? threadBuffer : Register("");
+}
+
+// Allocated on the first zone of the thread and pushed to the list.
+ProfileThreadBuffer* CpuProfiler::Register(const string& name)
+{
+	threadBuffer = new ProfileThreadBuffer();
+	threadBuffer->id = threadCount.fetch_add(1, memory_order_relaxed);
+	snprintf(threadBuffer->name, sizeof(threadBuffer->name), "%s", name.c_str());
+
+	ProfileThreadBuffer* head = buffers.load(memory_order_relaxed);
+	do threadBuffer->next = head;
+	while (!buffers.compare_exchange_weak(head, threadBuffer, memory_order_release, memory_order_relaxed));
+
+	return threadBuffer;
+}
+
+// Measured over the whole run, the time stamp counter is assumed invariant.
+double CpuProfiler::GetTicksPerMicrosecond()
+{
+	using namespace chrono;
+
+	// Too short to be precise right after start up.
+	while (steady_clock::now() - originTime < milliseconds(10)) this_thread::yield();
+
+	uint64_t ticks   = Now() - originTicks;
+	double   elapsed = duration<double, micro>(steady_clock::now() - originTime).count();
+	return (double)ticks / elapsed;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include <Debug.h>
+#include <Bounds.h>
+#include <Camera.h>
+#include <FrustumCuller.h>
+#include <BVH.h>
+#include <CullingBenchmark.h>
+
+using namespace std;
+using namespace Core::Maths;
+using namespace Core::Scene;
+using namespace Core::Debug;
+using namespace Renderer;
+
+#define CULLING_BENCHMARK_REPEATS 10
+
+bool CullingBenchmark::requested = false;
+
+// Elapsed milliseconds since the given time point.
+static double GetElapsedMs(const chrono::high_resolution_clock::time_point& start)
+{
+	return chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start).count();
+}
+
+// ===================================================================
+// CullingBenchmark public methods.
+// ===================================================================
+
+void CullingBenchmark::Run(const Camera& camera)
+{
+	requested = false;
+
+	for (unsigned int count : { 1000u, 100000u, 1000000u })
+		RunScene(camera, count);
+}
+
+// ===================================================================
+// CullingBenchmark private methods.
+// ===================================================================
+
+// Random boxes around the camera, up to its far distance.
+void CullingBenchmark::RunScene(const Camera& camera, const unsigned int& count)
+{
+	mt19937 random(count);
+	Vector3 eye   = camera.GetPosition();
+	float   range = camera.GetFarDistance();
+	uniform_real_distribution<float> position(-range, range), size(0.001f * range, 0.01f * range);
+
+	vector<Bounds> bounds(count);
+	for (Bounds& b : bounds)
+	{
+		b.center  = Vector3(eye.x + position(random), eye.y + position(random), eye.z + position(random));
+		b.extents = Vector3(size(random), size(random), size(random));
+	}
+
+	Frustum frustum = Frustum::FromMatrix(camera.GetVPMat());
+
+	// Flat structure of arrays culling.
+	FrustumCuller culler;
+	for (const Bounds& b : bounds) culler.Push(b);
+
+	CullingStats flatStats;
+	auto start = chrono::high_resolution_clock::now();
+	for (int i = 0; i < CULLING_BENCHMARK_REPEATS; i++) flatStats = culler.Cull(frustum);
+	double flatMs = GetElapsedMs(start) / CULLING_BENCHMARK_REPEATS;
+
+	// Hierarchy built by insertions, then rebuilt with the surface area heuristic.
+	BVH bvh;
+	vector<int> proxies(count);
+	start = chrono::high_resolution_clock::now();
+	for (unsigned int i = 0; i < count; i++) proxies[i] = bvh.Insert(bounds[i], (void*)(uintptr_t)i);
+	double insertMs = GetElapsedMs(start);
+
+	start = chrono::high_resolution_clock::now();
+	bvh.Rebuild();
+	double buildMs = GetElapsedMs(start);
+
+	vector<void*> visible;
+	visible.reserve(count);
+	CullingStats bvhStats;
+	start = chrono::high_resolution_clock::now();
+	for (int i = 0; i < CULLING_BENCHMARK_REPEATS; i++)
+	{
+		visible.clear();
+		bvhStats = bvh.Cull(frustum, visible);
+	}
+	double bvhMs = GetElapsedMs(start) / CULLING_BENCHMARK_REPEATS;
+
+	// Move one node out of a hundred by a few times its size.
+	unsigned int reinserted = 0;
+	start = chrono::high_resolution_clock::now();
+	for (unsigned int i = 0; i < count; i += 100)
+	{
+		bounds[i].center += bounds[i].extents * 4;
+		reinserted += bvh.Move(proxies[i], bounds[i]);
+	}
+	double moveMs = GetElapsedMs(start);
+
+	Log(LogType::INFO, "Culling " + to_string(count) + " nodes: flat " + to_string(flatMs) + " ms (" + to_string(flatStats.visible) + " visible), "
+					   "BVH " + to_string(bvhMs) + " ms (" + to_string(bvhStats.visible) + " visible, " + to_string(bvhStats.tested) + " nodes tested, height " + to_string(bvh.GetHeight()) + "), "
+					   "insertions " + to_string(insertMs) + " ms, SAH build " + to_string(buildMs) + " ms, "
+					   "1% moved " + to_string(moveMs) + " ms (" + to_string(reinserted) + " reinserted).");
+}
\ No newline at end of file
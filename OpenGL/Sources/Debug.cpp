@@ -2,6 +2,7 @@
 #include <fstream>
 #include <time.h>
 #include <vector>
+#include <mutex>
 
 #include <Matrix.h>
 #include <UserInterface.h>
@@ -29,6 +30,9 @@ void LogSystem::Print(const LogType& logType, const char* fileName, const int& l
 	}
 
 	output << GetTimestamp() << type << fileName << " (line: " << line << "): " << message << "\n";
+
+	// Logged from the main and render threads.
+	lock_guard<mutex> lock(UI::UserInterface::logMutex);
 	UI::UserInterface::logBuffer.push_back(pair(logType, output.str()));
 }
 
@@ -0,0 +1,54 @@
+#include <glad/glad.h>
+
+#include <cmath>
+#include <cstring>
+
+#include <Matrix.h>
+#include <LightManager.h>
+#include <FrameRing.h>
+#include <GLState.h>
+#include <Camera.h>
+#include <FrameConstants.h>
+
+using namespace std;
+using namespace Core::Maths;
+using namespace Renderer;
+
+// Frame constants static declaration.
+FrameConstantsData FrameConstants::data;
+
+// ===================================================================
+// FrameConstants public methods.
+// ===================================================================
+
+// Compute camera matrices once per frame and upload them to every shader.
+void FrameConstants::Update(const Camera& camera, const float& time, const float& deltaTime, const int& width, const int& height)
+{
+	Matrix4 view       = camera.GetViewMat();
+	Matrix4 projection = camera.GetPerspective();
+	Matrix4 viewProj   = view * projection;
+	Vector3 position   = camera.GetPosition();
+
+	memcpy(data.view,       &view      .m[0][0], sizeof(data.view));
+	memcpy(data.projection, &projection.m[0][0], sizeof(data.projection));
+	memcpy(data.viewProj,   &viewProj  .m[0][0], sizeof(data.viewProj));
+
+	data.cameraPos[0] = position.x; data.cameraPos[1] = position.y; data.cameraPos[2] = position.z; data.cameraPos[3] = 1;
+	data.time[0]      = time;       data.time[1]      = deltaTime;  data.time[2]      = 0;          data.time[3]      = 0;
+	data.viewport[0]  = (float)width;
+	data.viewport[1]  = (float)height;
+	data.viewport[2]  = width  > 0 ? 1.f / width  : 0;
+	data.viewport[3]  = height > 0 ? 1.f / height : 0;
+
+	// Exponential depth slices of the lights clusters: slice = log(depth) * scale + bias.
+	float zNear = camera.GetNearDistance(), zFar = camera.GetFarDistance();
+	data.clusters[0]  = zNear;
+	data.clusters[1]  = zFar;
+	data.clusters[2]  = CLUSTER_Z / logf(zFar / zNear);
+	data.clusters[3]  = -CLUSTER_Z * logf(zNear) / logf(zFar / zNear);
+
+	// Written in this frame region of the ring, bound for every pass of the frame.
+	RingAllocation constants = FrameRing::AllocateUniform(sizeof(FrameConstantsData));
+	memcpy(constants.data, &data, sizeof(FrameConstantsData));
+	GLState::BindBufferRange(GL_UNIFORM_BUFFER, FRAME_CONSTANTS_BINDING, constants.buffer, constants.offset, sizeof(FrameConstantsData));
+}
@@ -0,0 +1,111 @@
+#include <GLFW/glfw3.h>
+
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <thread>
+#include <algorithm>
+
+#include <FramePacer.h>
+
+using namespace std;
+using namespace Core;
+
+// Frame pacer static declaration.
+FramePacingSettings FramePacer::settings        = { SwapMode::VSync, 0, false };
+FramePacingStats    FramePacer::stats           = { 0, 0, 0, 1 };
+bool                FramePacer::tearSupported   = false;
+int                 FramePacer::appliedInterval = INT_MIN;
+unsigned int        FramePacer::redrawFrames    = FRAME_PACER_SETTLE;
+double              FramePacer::deadline        = 0;
+
+// ===================================================================
+// FramePacer public methods.
+// ===================================================================
+
+void FramePacer::Init(GLFWwindow* window)
+{
+	tearSupported = glfwExtensionSupported("WGL_EXT_swap_control_tear") || glfwExtensionSupported("GLX_EXT_swap_control_tear");
+
+	// Any input or window event redraws on-demand frames, the user interface backend calls them after its own.
+	glfwSetCursorPosCallback      (window, [](GLFWwindow*, double, double)        { RequestRedraw(); });
+	glfwSetMouseButtonCallback    (window, [](GLFWwindow*, int, int, int)         { RequestRedraw(); });
+	glfwSetScrollCallback         (window, [](GLFWwindow*, double, double)        { RequestRedraw(); });
+	glfwSetKeyCallback            (window, [](GLFWwindow*, int, int, int, int)    { RequestRedraw(); });
+	glfwSetCharCallback           (window, [](GLFWwindow*, unsigned int)          { RequestRedraw(); });
+	glfwSetWindowFocusCallback    (window, [](GLFWwindow*, int)                   { RequestRedraw(); });
+	glfwSetCursorEnterCallback    (window, [](GLFWwindow*, int)                   { RequestRedraw(); });
+	glfwSetFramebufferSizeCallback(window, [](GLFWwindow*, int, int)              { RequestRedraw(); });
+	glfwSetWindowRefreshCallback  (window, [](GLFWwindow*)                        { RequestRedraw(); });
+}
+
+// Sleeps overshoot by up to the scheduler period, so the end of the wait spins.
+void FramePacer::Limit()
+{
+	if (settings.frameLimit <= 0)
+	{
+		deadline = 0;
+		return;
+	}
+
+	double period = 1.0 / settings.frameLimit;
+	double now    = glfwGetTime();
+
+	// Frames more than a period late restart from now instead of catching up in a burst.
+	deadline += period;
+	if (deadline < now - period || deadline > now + period) deadline = now;
+
+	while ((deadline - glfwGetTime()) * 1000 > stats.sleepEstimateMs)
+	{
+		double start = glfwGetTime();
+		this_thread::sleep_for(chrono::milliseconds(1));
+
+		// Rises with the slowest sleeps, decays slowly.
+		float sleptMs = (float)((glfwGetTime() - start) * 1000);
+		stats.sleepEstimateMs = max(sleptMs, stats.sleepEstimateMs * 0.99f + sleptMs * 0.01f);
+	}
+	while (glfwGetTime() < deadline) this_thread::yield();
+
+	stats.limiterErrorMs += ((float)fabs(glfwGetTime() - deadline) * 1000 - stats.limiterErrorMs) * 0.05f;
+}
+
+void FramePacer::WaitEvents(const bool& continuous)
+{
+	if (continuous || redrawFrames > 0) glfwPollEvents();
+	else                                glfwWaitEventsTimeout(FRAME_PACER_IDLE_TIMEOUT);
+}
+
+bool FramePacer::ShouldRender(const bool& changed)
+{
+	if (changed) RequestRedraw();
+	if (redrawFrames == 0)
+	{
+		stats.skipped++;
+		return false;
+	}
+
+	redrawFrames--;
+	stats.rendered++;
+	return true;
+}
+
+void FramePacer::RequestRedraw() { redrawFrames = FRAME_PACER_SETTLE; }
+
+int FramePacer::GetSwapInterval()
+{
+	switch (settings.swapMode)
+	{
+		case SwapMode::Immediate: return 0;
+		case SwapMode::HalfRate:  return 2;
+		case SwapMode::Adaptive:  return tearSupported ? -1 : 1;
+		default:                  return 1;
+	}
+}
+
+void FramePacer::ApplySwapInterval(const int& interval)
+{
+	if (interval == appliedInterval) return;
+
+	glfwSwapInterval(interval);
+	appliedInterval = interval;
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include <mutex>
+#include <condition_variable>
+
+#include <Clock.h>
+#include <UserInterface.h>
+#include <FrameQueue.h>
+
+using namespace std;
+using namespace Renderer;
+
+// Frame queue static declaration.
+FrameLatencyStats  FrameQueue::stats = { 0, 0, 0, 0, 0, 0 };
+RenderStats        FrameQueue::renderStats = {};
+RenderStats        FrameQueue::results     = {};
+SceneSnapshot      FrameQueue::slots[FRAME_QUEUE_DEPTH];
+unsigned long long FrameQueue::published = 0, FrameQueue::popped = 0, FrameQueue::released = 0;
+bool               FrameQueue::closed    = false;
+mutex              FrameQueue::queueMutex;
+condition_variable FrameQueue::freed, FrameQueue::ready;
+
+// Averages over roughly the last 20 frames.
+static void Accumulate(float& average, const double& seconds)
+{
+	average += ((float)seconds * 1000.f - average) * 0.05f;
+}
+
+// ===================================================================
+// FrameQueue public methods.
+// ===================================================================
+
+SceneSnapshot* FrameQueue::Acquire()
+{
+	double start = Core::GetTime();
+
+	unique_lock<mutex> lock(queueMutex);
+	freed.wait(lock, []() { return published - released < FRAME_QUEUE_DEPTH; });
+
+	Accumulate(stats.mainWait, Core::GetTime() - start);
+
+	SceneSnapshot* snapshot = &slots[published % FRAME_QUEUE_DEPTH];
+	snapshot->frame = published;
+	return snapshot;
+}
+
+void FrameQueue::Publish(SceneSnapshot* snapshot)
+{
+	{
+		lock_guard<mutex> lock(queueMutex);
+		snapshot->publishTime = Core::GetTime();
+		published++;
+		stats.depth = (unsigned int)(published - released);
+	}
+	ready.notify_one();
+}
+
+SceneSnapshot* FrameQueue::Pop()
+{
+	double start = Core::GetTime();
+
+	unique_lock<mutex> lock(queueMutex);
+	ready.wait(lock, []() { return popped < published || closed; });
+	if (popped == published) return nullptr;
+
+	SceneSnapshot* snapshot = &slots[popped++ % FRAME_QUEUE_DEPTH];
+
+	snapshot->renderTime = Core::GetTime();
+	Accumulate(stats.renderWait, snapshot->renderTime - start);
+	Accumulate(stats.queued,     snapshot->renderTime - snapshot->publishTime);
+	return snapshot;
+}
+
+// The slot is only reused by the main thread once the frame was presented.
+void FrameQueue::Release(SceneSnapshot* snapshot, const double& presentTime, const RenderStats& frameResults)
+{
+	{
+		lock_guard<mutex> lock(queueMutex);
+		Accumulate(stats.inputToPresent, presentTime - snapshot->inputTime);
+		Accumulate(stats.render,         presentTime - snapshot->renderTime);
+		released++;
+		stats.depth = (unsigned int)(published - released);
+
+		vector<FrameDrawCounts> frameDraws    = move(results.frameDraws);
+		vector<GpuFrameTime>    gpuFrameTimes = move(results.gpuFrameTimes);
+		results = frameResults;
+		frameDraws.insert(frameDraws.end(), frameResults.frameDraws.begin(), frameResults.frameDraws.end());
+		gpuFrameTimes.insert(gpuFrameTimes.end(), frameResults.gpuFrameTimes.begin(), frameResults.gpuFrameTimes.end());
+		results.frameDraws    = move(frameDraws);
+		results.gpuFrameTimes = move(gpuFrameTimes);
+	}
+	freed.notify_one();
+}
+
+void FrameQueue::CopyRenderStats()
+{
+	lock_guard<mutex> lock(queueMutex);
+	renderStats = results;
+	renderStats.latency = stats;
+	results.frameDraws.clear();
+	results.gpuFrameTimes.clear();
+}
+
+void FrameQueue::Close()
+{
+	{
+		lock_guard<mutex> lock(queueMutex);
+		closed = true;
+	}
+	ready.notify_all();
+	freed.notify_all();
+}
+
+void FrameQueue::Unload()
+{
+	for (SceneSnapshot& slot : slots) Core::UI::UserInterface::Release(slot.ui);
+	published = popped = released = 0;
+	closed = false;
+}
\ No newline at end of file
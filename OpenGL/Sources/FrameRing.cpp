@@ -0,0 +1,155 @@
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <Debug.h>
+#include <GLState.h>
+#include <FrameRing.h>
+
+using namespace std;
+using namespace Core::Debug;
+using namespace Renderer;
+
+// Frame ring static declaration.
+FrameRingStats FrameRing::stats = { 0, 0, 0, 0 };
+GLuint         FrameRing::buffer = 0;
+uint8_t*       FrameRing::mapped = nullptr;
+GLsync         FrameRing::fences[FRAME_RING_REGIONS] = { nullptr };
+vector<GLuint> FrameRing::overflowBuffers[FRAME_RING_REGIONS];
+unsigned int   FrameRing::region = 0;
+size_t         FrameRing::regionSize = FRAME_RING_REGION_SIZE, FrameRing::head = 0, FrameRing::requiredSize = 0;
+GLint          FrameRing::uniformAlignment = 256, FrameRing::storageAlignment = 256;
+
+static const GLbitfield ringFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+// ===================================================================
+// FrameRing public methods.
+// ===================================================================
+
+void FrameRing::Init()
+{
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT,        &uniformAlignment);
+	glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageAlignment);
+
+	CreateBuffer();
+}
+
+void FrameRing::BeginFrame()
+{
+	region = (region + 1) % FRAME_RING_REGIONS;
+	WaitRegion(region);
+
+	// The region is free again, so are the temporary buffers allocated with it.
+	if (!overflowBuffers[region].empty())
+	{
+		glDeleteBuffers((GLsizei)overflowBuffers[region].size(), overflowBuffers[region].data());
+		overflowBuffers[region].clear();
+		GLState::Invalidate();
+	}
+
+	// A frame overflowed its region: wait for every region and grow the ring once.
+	if (requiredSize > regionSize)
+	{
+		for (unsigned int i = 0; i < FRAME_RING_REGIONS; i++) WaitRegion(i);
+
+		while (regionSize < requiredSize) regionSize *= 2;
+		Log(LogType::INFO, string("Frame ring regions grown to ") + to_string(regionSize >> 10) + " KB.");
+		CreateBuffer();
+	}
+
+	head = 0;
+	requiredSize = 0;
+}
+
+void FrameRing::EndFrame()
+{
+	stats.used       = head;
+	stats.regionSize = regionSize;
+
+	fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void FrameRing::Unload()
+{
+	for (unsigned int i = 0; i < FRAME_RING_REGIONS; i++)
+	{
+		if (fences[i]) glDeleteSync(fences[i]);
+		fences[i] = nullptr;
+
+		if (!overflowBuffers[i].empty()) glDeleteBuffers((GLsizei)overflowBuffers[i].size(), overflowBuffers[i].data());
+		overflowBuffers[i].clear();
+	}
+
+	glDeleteBuffers(1, &buffer);
+	buffer = 0;
+	mapped = nullptr;
+}
+
+// Aligned bump allocation in the current frame region.
+RingAllocation FrameRing::Allocate(const size_t& size, const size_t& alignment)
+{
+	size_t offset = (head + alignment - 1) / alignment * alignment;
+	if (offset + size <= regionSize)
+	{
+		head = offset + size;
+		size_t regionOffset = regionSize * region + offset;
+		return { buffer, (GLintptr)regionOffset, size, mapped + regionOffset };
+	}
+
+	// Out of space: serve this frame from a temporary buffer, released with the region.
+	requiredSize = max(requiredSize, offset) + size;
+	stats.overflows++;
+
+	GLuint overflow;
+	glCreateBuffers(1, &overflow);
+	glNamedBufferStorage(overflow, size, nullptr, ringFlags);
+	overflowBuffers[region].push_back(overflow);
+
+	return { overflow, 0, size, glMapNamedBufferRange(overflow, 0, size, ringFlags) };
+}
+
+RingAllocation FrameRing::AllocateUniform(const size_t& size)
+{
+	return Allocate(size, uniformAlignment);
+}
+
+RingAllocation FrameRing::AllocateStorage(const size_t& size)
+{
+	return Allocate(size, storageAlignment);
+}
+
+// ===================================================================
+// FrameRing private methods.
+// ===================================================================
+
+void FrameRing::CreateBuffer()
+{
+	glDeleteBuffers(1, &buffer);
+	GLState::Invalidate();
+
+	glCreateBuffers(1, &buffer);
+	glNamedBufferStorage(buffer, regionSize * FRAME_RING_REGIONS, nullptr, ringFlags);
+	mapped = (uint8_t*)glMapNamedBufferRange(buffer, 0, regionSize * FRAME_RING_REGIONS, ringFlags);
+
+	Assert(mapped != nullptr, "Could not map the frame ring buffer.");
+	stats.regionSize = regionSize;
+}
+
+// Block until the GPU finished the commands fenced with the given region.
+void FrameRing::WaitRegion(const unsigned int& _region)
+{
+	if (fences[_region] == nullptr) return;
+
+	GLenum status = glClientWaitSync(fences[_region], 0, 0);
+	if (status == GL_TIMEOUT_EXPIRED)
+	{
+		stats.fenceWaits++;
+		while (status == GL_TIMEOUT_EXPIRED)
+			status = glClientWaitSync(fences[_region], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+	}
+
+	glDeleteSync(fences[_region]);
+	fences[_region] = nullptr;
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include <cmath>
+#include <vector>
+#include <immintrin.h>
+
+#include <Matrix.h>
+#include <Bounds.h>
+#include <FrustumCuller.h>
+
+using namespace std;
+using namespace Core::Maths;
+using namespace Renderer;
+
+// ===================================================================
+// Frustum public methods.
+// ===================================================================
+
+Frustum Frustum::FromMatrix(const Matrix4& viewProj)
+{
+	// Clip coordinates are v * viewProj: each clip component is a matrix column.
+	auto column = [&](const int& c, const int& r) { return viewProj.m[r][c]; };
+
+	Frustum frustum;
+	for (int r = 0; r < 4; r++)
+	{
+		frustum.planes[0][r] = column(3, r) + column(0, r); // Left.
+		frustum.planes[1][r] = column(3, r) - column(0, r); // Right.
+		frustum.planes[2][r] = column(3, r) + column(1, r); // Bottom.
+		frustum.planes[3][r] = column(3, r) - column(1, r); // Top.
+		frustum.planes[4][r] = column(3, r) + column(2, r); // Near, as clipped by OpenGL (-w < z).
+		frustum.planes[5][r] = column(3, r) - column(2, r); // Far.
+	}
+
+	for (float* plane : frustum.planes)
+	{
+		float length = sqrtf(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+		for (int i = 0; i < 4; i++) plane[i] /= length;
+	}
+
+	return frustum;
+}
+
+// ===================================================================
+// FrustumCuller public methods.
+// ===================================================================
+
+void FrustumCuller::Clear()
+{
+	m_count = 0;
+	m_centerX .clear(); m_centerY .clear(); m_centerZ .clear();
+	m_extentsX.clear(); m_extentsY.clear(); m_extentsZ.clear();
+}
+
+void FrustumCuller::Push(const Bounds& bounds)
+{
+	m_centerX .push_back(bounds.center.x);  m_centerY .push_back(bounds.center.y);  m_centerZ .push_back(bounds.center.z);
+	m_extentsX.push_back(bounds.extents.x); m_extentsY.push_back(bounds.extents.y); m_extentsZ.push_back(bounds.extents.z);
+	m_count++;
+}
+
+bool   FrustumCuller::IsVisible(const size_t& index) const { return m_visible[index] != 0; }
+size_t FrustumCuller::GetCount() const { return m_count; }
+
+// A box is outside when its projected radius on a plane normal does not reach the plane.
+CullingStats FrustumCuller::Cull(const Frustum& frustum)
+{
+	// Pad to a whole number of batches with empty boxes.
+	size_t padded = (m_count + CULL_BATCH_SIZE - 1) / CULL_BATCH_SIZE * CULL_BATCH_SIZE;
+	m_centerX .resize(padded, 0); m_centerY .resize(padded, 0); m_centerZ .resize(padded, 0);
+	m_extentsX.resize(padded, 0); m_extentsY.resize(padded, 0); m_extentsZ.resize(padded, 0);
+	m_visible .resize(padded);
+
+	for (size_t i = 0; i < padded; i += CULL_BATCH_SIZE)
+	{
+	#ifdef __AVX__
+		__m256 cx = _mm256_loadu_ps(&m_centerX [i]), cy = _mm256_loadu_ps(&m_centerY [i]), cz = _mm256_loadu_ps(&m_centerZ [i]);
+		__m256 ex = _mm256_loadu_ps(&m_extentsX[i]), ey = _mm256_loadu_ps(&m_extentsY[i]), ez = _mm256_loadu_ps(&m_extentsZ[i]);
+		__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+		for (const float* plane : frustum.planes)
+		{
+			__m256 nx = _mm256_set1_ps(plane[0]), ny = _mm256_set1_ps(plane[1]), nz = _mm256_set1_ps(plane[2]);
+
+			// Signed distance of the center plus the box projected radius.
+			__m256 dist   = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(cx, nx), _mm256_mul_ps(cy, ny)), _mm256_add_ps(_mm256_mul_ps(cz, nz), _mm256_set1_ps(plane[3])));
+			__m256 radius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ex, _mm256_set1_ps(fabsf(plane[0]))), _mm256_mul_ps(ey, _mm256_set1_ps(fabsf(plane[1])))), _mm256_mul_ps(ez, _mm256_set1_ps(fabsf(plane[2]))));
+			inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(dist, radius), _mm256_setzero_ps(), _CMP_GE_OQ));
+		}
+
+		int mask = _mm256_movemask_ps(inside);
+	#else
+		__m128 cx = _mm_loadu_ps(&m_centerX [i]), cy = _mm_loadu_ps(&m_centerY [i]), cz = _mm_loadu_ps(&m_centerZ [i]);
+		__m128 ex = _mm_loadu_ps(&m_extentsX[i]), ey = _mm_loadu_ps(&m_extentsY[i]), ez = _mm_loadu_ps(&m_extentsZ[i]);
+		__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+		for (const float* plane : frustum.planes)
+		{
+			__m128 nx = _mm_set1_ps(plane[0]), ny = _mm_set1_ps(plane[1]), nz = _mm_set1_ps(plane[2]);
+
+			// Signed distance of the center plus the box projected radius.
+			__m128 dist   = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, nx), _mm_mul_ps(cy, ny)), _mm_add_ps(_mm_mul_ps(cz, nz), _mm_set1_ps(plane[3])));
+			__m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ex, _mm_set1_ps(fabsf(plane[0]))), _mm_mul_ps(ey, _mm_set1_ps(fabsf(plane[1])))), _mm_mul_ps(ez, _mm_set1_ps(fabsf(plane[2]))));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(dist, radius), _mm_setzero_ps()));
+		}
+
+		int mask = _mm_movemask_ps(inside);
+	#endif
+
+		for (int j = 0; j < CULL_BATCH_SIZE; j++)
+			m_visible[i + j] = (mask >> j) & 1;
+	}
+
+	CullingStats stats = { 0, 0, (unsigned int)m_count };
+	for (size_t i = 0; i < m_count; i++)
+		m_visible[i] ? stats.visible++ : stats.culled++;
+
+	return stats;
+}
\ No newline at end of file
@@ -0,0 +1,161 @@
+#include <glad/glad.h>
+
+#include <unordered_map>
+
+#include <GLState.h>
+
+using namespace std;
+using namespace Renderer;
+
+// GL state static declaration.
+GLStateStats               GLState::stats = {};
+GLStateStats               GLState::frame = {};
+GLuint                     GLState::program         = GL_STATE_UNKNOWN;
+GLuint                     GLState::vertexArray     = GL_STATE_UNKNOWN;
+GLuint                     GLState::indirectBuffer  = GL_STATE_UNKNOWN;
+GLuint                     GLState::parameterBuffer = GL_STATE_UNKNOWN;
+GLuint                     GLState::textures[GL_STATE_TEXTURE_UNITS];
+GLuint                     GLState::samplers[GL_STATE_TEXTURE_UNITS];
+GLState::BufferBinding     GLState::uniformBuffers[GL_STATE_BUFFER_BINDINGS];
+GLState::BufferBinding     GLState::storageBuffers[GL_STATE_BUFFER_BINDINGS];
+unordered_map<GLenum, bool> GLState::capabilities;
+
+// ===================================================================
+// GLState public methods.
+// ===================================================================
+
+void GLState::BeginFrame()
+{
+	stats = frame;
+	frame = {};
+}
+
+void GLState::Invalidate()
+{
+	program = vertexArray = indirectBuffer = parameterBuffer = GL_STATE_UNKNOWN;
+	for (size_t i = 0; i < GL_STATE_TEXTURE_UNITS; i++) textures[i] = samplers[i] = GL_STATE_UNKNOWN;
+	for (size_t i = 0; i < GL_STATE_BUFFER_BINDINGS; i++) uniformBuffers[i] = storageBuffers[i] = { GL_STATE_UNKNOWN, 0, 0 };
+	capabilities.clear();
+}
+
+void GLState::UseProgram(const GLuint& _program)
+{
+	if (Update(program, _program, GLStateCall::Program)) glUseProgram(_program);
+}
+
+void GLState::BindVertexArray(const GLuint& _vertexArray)
+{
+	if (Update(vertexArray, _vertexArray, GLStateCall::VertexArray)) glBindVertexArray(_vertexArray);
+}
+
+void GLState::BindTextureUnit(const GLuint& unit, const GLuint& texture)
+{
+	if (unit >= GL_STATE_TEXTURE_UNITS)
+	{
+		Count(true, GLStateCall::Texture);
+		glBindTextureUnit(unit, texture);
+	}
+	else if (Update(textures[unit], texture, GLStateCall::Texture)) glBindTextureUnit(unit, texture);
+}
+
+void GLState::BindSampler(const GLuint& unit, const GLuint& sampler)
+{
+	if (unit >= GL_STATE_TEXTURE_UNITS)
+	{
+		Count(true, GLStateCall::Sampler);
+		glBindSampler(unit, sampler);
+	}
+	else if (Update(samplers[unit], sampler, GLStateCall::Sampler)) glBindSampler(unit, sampler);
+}
+
+void GLState::BindBuffer(const GLenum& target, const GLuint& buffer)
+{
+	GLuint* shadow = target == GL_DRAW_INDIRECT_BUFFER ? &indirectBuffer : target == GL_PARAMETER_BUFFER_ARB ? &parameterBuffer : nullptr;
+	if (shadow == nullptr)
+	{
+		Count(true, GLStateCall::Buffer);
+		glBindBuffer(target, buffer);
+	}
+	else if (Update(*shadow, buffer, GLStateCall::Buffer)) glBindBuffer(target, buffer);
+}
+
+void GLState::BindBufferBase(const GLenum& target, const GLuint& index, const GLuint& buffer)
+{
+	if (UpdateIndexed(target, index, { buffer, 0, -1 })) glBindBufferBase(target, index, buffer);
+}
+
+void GLState::BindBufferRange(const GLenum& target, const GLuint& index, const GLuint& buffer, const GLintptr& offset, const GLsizeiptr& size)
+{
+	if (UpdateIndexed(target, index, { buffer, offset, size })) glBindBufferRange(target, index, buffer, offset, size);
+}
+
+void GLState::Enable(const GLenum& capability)
+{
+	auto it = capabilities.find(capability);
+	bool issue = it == capabilities.end() || !it->second;
+	Count(issue, GLStateCall::Enable);
+	if (!issue) return;
+
+	capabilities[capability] = true;
+	glEnable(capability);
+}
+
+void GLState::Disable(const GLenum& capability)
+{
+	auto it = capabilities.find(capability);
+	bool issue = it == capabilities.end() || it->second;
+	Count(issue, GLStateCall::Enable);
+	if (!issue) return;
+
+	capabilities[capability] = false;
+	glDisable(capability);
+}
+
+const char* GLState::GetCallName(const GLStateCall& call)
+{
+	switch (call)
+	{
+	case GLStateCall::Program:     return "Use program";
+	case GLStateCall::VertexArray: return "Bind vertex array";
+	case GLStateCall::Texture:     return "Bind texture";
+	case GLStateCall::Sampler:     return "Bind sampler";
+	case GLStateCall::Buffer:      return "Bind buffer";
+	case GLStateCall::Enable:      return "Enable / disable";
+	default:                       return "Unknown";
+	}
+}
+
+// ===================================================================
+// GLState private methods.
+// ===================================================================
+
+bool GLState::Update(GLuint& shadow, const GLuint& value, const GLStateCall& call)
+{
+	bool issue = shadow != value;
+	Count(issue, call);
+	shadow = value;
+	return issue;
+}
+
+// Uniform and storage bindings are shadowed, the generic binding point they also set is not.
+bool GLState::UpdateIndexed(const GLenum& target, const GLuint& index, const BufferBinding& binding)
+{
+	BufferBinding* bindings = target == GL_UNIFORM_BUFFER ? uniformBuffers : target == GL_SHADER_STORAGE_BUFFER ? storageBuffers : nullptr;
+	if (bindings == nullptr || index >= GL_STATE_BUFFER_BINDINGS)
+	{
+		Count(true, GLStateCall::Buffer);
+		return true;
+	}
+
+	BufferBinding& shadow = bindings[index];
+	bool issue = shadow.buffer != binding.buffer || shadow.offset != binding.offset || shadow.size != binding.size;
+	Count(issue, GLStateCall::Buffer);
+	shadow = binding;
+	return issue;
+}
+
+void GLState::Count(const bool& issued, const GLStateCall& call)
+{
+	if (issued) frame.issued [(size_t)call]++;
+	else        frame.skipped[(size_t)call]++;
+}
\ No newline at end of file
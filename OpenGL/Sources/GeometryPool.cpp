@@ -0,0 +1,143 @@
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <vector>
+
+#include <Vertex.h>
+#include <GeometryPool.h>
+
+using namespace std;
+using namespace Core;
+using namespace Resources;
+
+// Geometry pool static declaration.
+GLuint       GeometryPool::VAO = 0, GeometryPool::VBO = 0, GeometryPool::EBO = 0;
+GLuint       GeometryPool::depthVAO = 0, GeometryPool::positionBuffer = 0;
+unsigned int GeometryPool::vertexCount = 0, GeometryPool::vertexCapacity = 0;
+unsigned int GeometryPool::indexCount  = 0, GeometryPool::indexCapacity  = 0;
+unsigned int GeometryPool::meshCount   = 0;
+
+// ===================================================================
+// GeometryPool public methods.
+// ===================================================================
+
+GeometryRange GeometryPool::Add(const vector<Maths::Vertex>& vertices, const vector<uint32_t>& indices)
+{
+	if (VAO == 0) Init();
+
+	// Grow buffers by doubling, keeping already added meshes.
+	unsigned int newVertexCapacity = vertexCapacity, newIndexCapacity = indexCapacity;
+	while (vertexCount + vertices.size() > newVertexCapacity) newVertexCapacity *= 2;
+	while (indexCount  + indices .size() > newIndexCapacity)  newIndexCapacity  *= 2;
+
+	if (newVertexCapacity != vertexCapacity)
+	{
+		Grow(VBO, sizeof(Maths::Vertex) * vertexCount, sizeof(Maths::Vertex) * newVertexCapacity);
+		glVertexArrayVertexBuffer(VAO, 0, VBO, 0, sizeof(Maths::Vertex));
+		Grow(positionBuffer, sizeof(Maths::Vector3) * vertexCount, sizeof(Maths::Vector3) * newVertexCapacity);
+		glVertexArrayVertexBuffer(depthVAO, 0, positionBuffer, 0, sizeof(Maths::Vector3));
+		vertexCapacity = newVertexCapacity;
+	}
+	if (newIndexCapacity != indexCapacity)
+	{
+		Grow(EBO, sizeof(uint32_t) * indexCount, sizeof(uint32_t) * newIndexCapacity);
+		glVertexArrayElementBuffer(VAO, EBO);
+		glVertexArrayElementBuffer(depthVAO, EBO);
+		indexCapacity = newIndexCapacity;
+	}
+
+	// Append mesh data, indices stay relative to the mesh base vertex.
+	GeometryRange range = { vertexCount, indexCount, (unsigned int)indices.size(), meshCount++ };
+	glNamedBufferSubData(VBO, sizeof(Maths::Vertex) * vertexCount, sizeof(Maths::Vertex) * vertices.size(), vertices.data());
+	glNamedBufferSubData(EBO, sizeof(uint32_t)      * indexCount,  sizeof(uint32_t)      * indices .size(), indices .data());
+
+	// Same vertices, positions only: depth passes fetch a third of the vertex data.
+	vector<Maths::Vector3> positions(vertices.size());
+	for (size_t i = 0; i < vertices.size(); i++) positions[i] = vertices[i].pos;
+	glNamedBufferSubData(positionBuffer, sizeof(Maths::Vector3) * vertexCount, sizeof(Maths::Vector3) * positions.size(), positions.data());
+
+	vertexCount += (unsigned int)vertices.size();
+	indexCount  += (unsigned int)indices .size();
+	return range;
+}
+
+void GeometryPool::Unload()
+{
+	glDeleteVertexArrays(1, &VAO);
+	glDeleteVertexArrays(1, &depthVAO);
+	glDeleteBuffers(1, &VBO);
+	glDeleteBuffers(1, &EBO);
+	glDeleteBuffers(1, &positionBuffer);
+
+	VAO = VBO = EBO = depthVAO = positionBuffer = 0;
+	vertexCount = vertexCapacity = indexCount = indexCapacity = meshCount = 0;
+}
+
+// ===================================================================
+// GeometryPool private methods.
+// ===================================================================
+
+void GeometryPool::Init()
+{
+	vertexCapacity = 1 << 16;
+	indexCapacity  = 1 << 18;
+
+	glCreateBuffers(1, &VBO);
+	glNamedBufferStorage(VBO, sizeof(Maths::Vertex) * vertexCapacity, nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+	glCreateBuffers(1, &EBO);
+	glNamedBufferStorage(EBO, sizeof(uint32_t) * indexCapacity, nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+	glCreateVertexArrays(1, &VAO);
+
+	glVertexArrayVertexBuffer(VAO, 0, VBO, 0, sizeof(Maths::Vertex));
+	glVertexArrayElementBuffer(VAO, EBO);
+
+	glEnableVertexArrayAttrib(VAO, 0);
+	glEnableVertexArrayAttrib(VAO, 1);
+	glEnableVertexArrayAttrib(VAO, 2);
+
+	glVertexArrayAttribFormat(VAO, 0, 3, GL_FLOAT, GL_FALSE, offsetof(Maths::Vertex, Maths::Vertex::pos));
+	glVertexArrayAttribFormat(VAO, 1, 2, GL_FLOAT, GL_FALSE, offsetof(Maths::Vertex, Maths::Vertex::uv));
+	glVertexArrayAttribFormat(VAO, 2, 3, GL_FLOAT, GL_FALSE, offsetof(Maths::Vertex, Maths::Vertex::normal));
+
+	glVertexArrayAttribBinding(VAO, 0, 0);
+	glVertexArrayAttribBinding(VAO, 1, 0);
+	glVertexArrayAttribBinding(VAO, 2, 0);
+
+	// Instance index, advanced once per instance (buffer attached by the ModelManager).
+	glEnableVertexArrayAttrib(VAO, 3);
+	glVertexArrayAttribIFormat(VAO, 3, 1, GL_UNSIGNED_INT, 0);
+	glVertexArrayAttribBinding(VAO, 3, INSTANCE_BUFFER_INDEX);
+	glVertexArrayBindingDivisor(VAO, INSTANCE_BUFFER_INDEX, 1);
+
+	// Depth only layout: position and instance index, sharing the index buffer.
+	glCreateBuffers(1, &positionBuffer);
+	glNamedBufferStorage(positionBuffer, sizeof(Maths::Vector3) * vertexCapacity, nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+	glCreateVertexArrays(1, &depthVAO);
+	glVertexArrayVertexBuffer(depthVAO, 0, positionBuffer, 0, sizeof(Maths::Vector3));
+	glVertexArrayElementBuffer(depthVAO, EBO);
+
+	glEnableVertexArrayAttrib(depthVAO, 0);
+	glVertexArrayAttribFormat(depthVAO, 0, 3, GL_FLOAT, GL_FALSE, 0);
+	glVertexArrayAttribBinding(depthVAO, 0, 0);
+
+	glEnableVertexArrayAttrib(depthVAO, 3);
+	glVertexArrayAttribIFormat(depthVAO, 3, 1, GL_UNSIGNED_INT, 0);
+	glVertexArrayAttribBinding(depthVAO, 3, INSTANCE_BUFFER_INDEX);
+	glVertexArrayBindingDivisor(depthVAO, INSTANCE_BUFFER_INDEX, 1);
+}
+
+// Reallocate an immutable buffer to a bigger size and copy its used content.
+void GeometryPool::Grow(GLuint& buffer, const size_t& usedSize, const size_t& newSize)
+{
+	GLuint newBuffer;
+	glCreateBuffers(1, &newBuffer);
+	glNamedBufferStorage(newBuffer, newSize, nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+	if (usedSize > 0) glCopyNamedBufferSubData(buffer, newBuffer, 0, 0, usedSize);
+
+	glDeleteBuffers(1, &buffer);
+	buffer = newBuffer;
+}
\ No newline at end of file
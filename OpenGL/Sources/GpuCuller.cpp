@@ -0,0 +1,318 @@
+#include <glad/glad.h>
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+
+#include <Debug.h>
+#include <Mesh.h>
+#include <Model.h>
+#include <Shader.h>
+#include <Uniform.h>
+#include <GeometryPool.h>
+#include <FrameConstants.h>
+#include <FrameRing.h>
+#include <GLState.h>
+#include <ResourceManager.h>
+#include <ModelManager.h>
+#include <GpuCuller.h>
+
+using namespace std;
+using namespace Core::Debug;
+using namespace Core::Scene;
+using namespace Renderer;
+
+// GPU culler static declaration.
+bool                GpuCuller::hiZCulling    = false;
+bool                GpuCuller::indirectCount = false;
+unsigned int        GpuCuller::objectCount   = 0;
+unsigned int        GpuCuller::groupCount    = 0;
+vector<GpuDrawRun>  GpuCuller::runs;
+GLuint GpuCuller::cullProgram     = 0, GpuCuller::compactProgram = 0, GpuCuller::hiZProgram  = 0;
+GLuint GpuCuller::transformBuffer = 0, GpuCuller::objectBuffer   = 0, GpuCuller::templateBuffer = 0, GpuCuller::commandBuffer = 0;
+GLuint GpuCuller::visibleBuffer   = 0, GpuCuller::groupBuffer    = 0, GpuCuller::compactBuffer  = 0, GpuCuller::countBuffer   = 0;
+GLuint GpuCuller::depthTexture    = 0, GpuCuller::depthFramebuffer = 0, GpuCuller::hiZTexture = 0;
+int    GpuCuller::depthWidth      = 0, GpuCuller::depthHeight = 0;
+bool   GpuCuller::hiZEnabled      = false;
+Core::Maths::Matrix4 GpuCuller::hiZViewProj;
+unordered_map<SceneNode*, unsigned int> GpuCuller::objectIndices;
+
+// ===================================================================
+// GpuCuller public methods.
+// ===================================================================
+
+void GpuCuller::Init()
+{
+	cullProgram    = ResourceManager::CreateProgram({ { "Assets/Shaders/CullInstances.comp", Resources::ShaderType::ComputeShader } });
+	compactProgram = ResourceManager::CreateProgram({ { "Assets/Shaders/CompactDraws.comp",  Resources::ShaderType::ComputeShader } });
+	hiZProgram     = ResourceManager::CreateProgram({ { "Assets/Shaders/BuildHiZ.comp",      Resources::ShaderType::ComputeShader } });
+
+	Resources::Uniform<int>(cullProgram, "hiZ").Set(GPU_HIZ_UNIT);
+	Resources::Uniform<int>(hiZProgram, "source").Set(GPU_HIZ_UNIT);
+
+	// Without draw count parameters, every group command is drawn, culled ones having no instance.
+	indirectCount = GLAD_GL_ARB_indirect_parameters != 0;
+	if (!indirectCount) Log(LogType::WARNING, "ARB_indirect_parameters is not supported, GPU culling draws all commands.");
+}
+
+// Lay objects out in buffers: one draw group per mesh, groups sorted by texture.
+void GpuCuller::Build(const vector<GpuSceneObject>& sceneObjects)
+{
+	DeleteBuffers();
+	objectIndices.clear();
+	runs.clear();
+
+	vector<Resources::Mesh*> meshes;
+	unordered_map<Resources::Mesh*, unsigned int> groupOf;
+	for (const GpuSceneObject& object : sceneObjects)
+		if (groupOf.emplace(object.mesh, 0).second) meshes.push_back(object.mesh);
+
+	sort(meshes.begin(), meshes.end(), [](Resources::Mesh* a, Resources::Mesh* b) { return a->texture->GetTexture() < b->texture->GetTexture(); });
+	for (unsigned int i = 0; i < meshes.size(); i++) groupOf[meshes[i]] = i;
+
+	objectCount = (unsigned int)sceneObjects.size();
+	groupCount  = (unsigned int)meshes.size();
+	if (objectCount == 0) return;
+
+	// Objects bounds, transforms and group sizes.
+	vector<GpuObjectData> objects(objectCount);
+	vector<InstanceData>  transforms(objectCount);
+	vector<unsigned int>  groupSizes(groupCount, 0);
+
+	for (unsigned int i = 0; i < objectCount; i++)
+	{
+		const Core::Maths::Bounds& bounds = sceneObjects[i].bounds;
+		unsigned int group = groupOf[sceneObjects[i].mesh];
+
+		objects[i] = { { bounds.center.x, bounds.center.y, bounds.center.z, bounds.radius }, { bounds.extents.x, bounds.extents.y, bounds.extents.z, 0 }, { group, 0, 0, 0 } };
+		transforms[i] = sceneObjects[i].transform;
+
+		groupSizes[group]++;
+		objectIndices[sceneObjects[i].node] = i;
+	}
+
+	// Commands template without instances, visible objects are packed from each group base instance.
+	vector<DrawCommand>  commands(groupCount);
+	vector<unsigned int> groups(groupCount * 2);
+	unsigned int first = 0;
+	for (unsigned int g = 0; g < groupCount; g++)
+	{
+		const Resources::GeometryRange& range = meshes[g]->range;
+		commands[g] = { range.indexCount, 0, range.firstIndex, (GLint)range.baseVertex, first };
+		first += groupSizes[g];
+
+		GLuint texture = meshes[g]->texture->GetTexture();
+		if (runs.empty() || runs.back().texture != texture)
+			runs.push_back({ texture, g, 0 });
+
+		runs.back().groupCount++;
+		groups[g * 2]     = (unsigned int)runs.size() - 1;
+		groups[g * 2 + 1] = runs.back().firstGroup;
+	}
+
+	GLuint* buffers[] = { &transformBuffer, &objectBuffer, &templateBuffer, &commandBuffer, &visibleBuffer, &groupBuffer, &compactBuffer, &countBuffer };
+	for (GLuint* buffer : buffers) glCreateBuffers(1, buffer);
+
+	glNamedBufferStorage(transformBuffer, sizeof(InstanceData)  * objectCount, transforms.data(), GL_DYNAMIC_STORAGE_BIT);
+	glNamedBufferStorage(objectBuffer,    sizeof(GpuObjectData) * objectCount, objects.data(), 0);
+	glNamedBufferStorage(templateBuffer,  sizeof(DrawCommand)   * groupCount,  commands.data(), 0);
+	glNamedBufferStorage(commandBuffer,   sizeof(DrawCommand)   * groupCount,  nullptr, 0);
+	glNamedBufferStorage(visibleBuffer,   sizeof(GLuint)        * objectCount, nullptr, 0);
+	glNamedBufferStorage(groupBuffer,     sizeof(GLuint)        * groups.size(), groups.data(), 0);
+	glNamedBufferStorage(compactBuffer,   sizeof(DrawCommand)   * groupCount,  nullptr, 0);
+	glNamedBufferStorage(countBuffer,     sizeof(GLuint)        * runs.size(), nullptr, 0);
+}
+
+// Only moved objects transforms are uploaded, staged in the frame ring and copied on the GPU timeline.
+void GpuCuller::UpdateTransforms(const vector<pair<SceneNode*, InstanceData>>& moved)
+{
+	if (moved.empty() || objectCount == 0) return;
+
+	RingAllocation staging = FrameRing::Allocate(sizeof(InstanceData) * moved.size(), sizeof(InstanceData));
+	InstanceData* transforms = (InstanceData*)staging.data;
+
+	GLintptr offset = 0;
+	for (const pair<SceneNode*, InstanceData>& node : moved)
+	{
+		auto it = objectIndices.find(node.first);
+		if (it == objectIndices.end()) continue;
+
+		*transforms++ = node.second;
+		glCopyNamedBufferSubData(staging.buffer, transformBuffer, staging.offset + offset, sizeof(InstanceData) * it->second, sizeof(InstanceData));
+		offset += sizeof(InstanceData);
+	}
+}
+
+// Fill each group command with its visible instances, then pack non-empty commands per texture run.
+void GpuCuller::Cull(const bool& hiZ)
+{
+	hiZEnabled = hiZ;
+	if (objectCount == 0) return;
+
+	glCopyNamedBufferSubData(templateBuffer, commandBuffer, 0, 0, sizeof(DrawCommand) * groupCount);
+	glClearNamedBufferData(countBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+	GLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, INSTANCES_BINDING,    transformBuffer);
+	GLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, GPU_OBJECTS_BINDING,  objectBuffer);
+	GLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, GPU_COMMANDS_BINDING, commandBuffer);
+	GLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, GPU_VISIBLE_BINDING,  visibleBuffer);
+
+	bool useHiZ = hiZEnabled && hiZTexture != 0;
+	if (useHiZ) GLState::BindTextureUnit(GPU_HIZ_UNIT, hiZTexture);
+
+	GLState::UseProgram(cullProgram);
+	Resources::Uniform<int>(cullProgram, "objectCount").Set((int)objectCount);
+	Resources::Uniform<int>(cullProgram, "hiZCulling").Set(useHiZ);
+	Resources::Uniform<Core::Maths::Matrix4>(cullProgram, "hiZViewProj").Set(hiZViewProj);
+	glDispatchCompute((objectCount + 63) / 64, 1, 1);
+
+	if (indirectCount)
+	{
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+		GLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, GPU_GROUPS_BINDING,  groupBuffer);
+		GLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, GPU_COMPACT_BINDING, compactBuffer);
+		GLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, GPU_COUNTS_BINDING,  countBuffer);
+
+		GLState::UseProgram(compactProgram);
+		Resources::Uniform<int>(compactProgram, "groupCount").Set((int)groupCount);
+		glDispatchCompute((groupCount + 63) / 64, 1, 1);
+	}
+
+	// Commands, counts and instances indices are consumed by the draws.
+	glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+}
+
+void GpuCuller::Draw(const GLuint& program, const GLuint& sampler)
+{
+	if (objectCount == 0) return;
+
+	GLState::UseProgram(program);
+	GLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, INSTANCES_BINDING, transformBuffer);
+
+	// Instances read visible objects indices written by the culling shader.
+	GLState::BindVertexArray(Resources::GeometryPool::VAO);
+	glVertexArrayVertexBuffer(Resources::GeometryPool::VAO, INSTANCE_BUFFER_INDEX, visibleBuffer, 0, sizeof(GLuint));
+	GLState::BindSampler(1, sampler);
+
+	GLState::BindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectCount ? compactBuffer : commandBuffer);
+	if (indirectCount) GLState::BindBuffer(GL_PARAMETER_BUFFER_ARB, countBuffer);
+
+	for (size_t r = 0; r < runs.size(); r++)
+	{
+		GLState::BindTextureUnit(1, runs[r].texture);
+
+		const void* offset = (void*)(sizeof(DrawCommand) * runs[r].firstGroup);
+		if (indirectCount) glMultiDrawElementsIndirectCountARB(GL_TRIANGLES, GL_UNSIGNED_INT, offset, (GLintptr)(sizeof(GLuint) * r), runs[r].groupCount, 0);
+		else               glMultiDrawElementsIndirect        (GL_TRIANGLES, GL_UNSIGNED_INT, offset, runs[r].groupCount, 0);
+	}
+
+	// Depth of this frame is used to cull the next one.
+	if (hiZEnabled) BuildHiZ();
+}
+
+// Same commands from the position only vertex stream, without textures.
+void GpuCuller::DrawDepth(const GLuint& depthProgram)
+{
+	if (objectCount == 0) return;
+
+	GLState::UseProgram(depthProgram);
+	GLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, INSTANCES_BINDING, transformBuffer);
+
+	GLState::BindVertexArray(Resources::GeometryPool::depthVAO);
+	glVertexArrayVertexBuffer(Resources::GeometryPool::depthVAO, INSTANCE_BUFFER_INDEX, visibleBuffer, 0, sizeof(GLuint));
+
+	GLState::BindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectCount ? compactBuffer : commandBuffer);
+	if (indirectCount) GLState::BindBuffer(GL_PARAMETER_BUFFER_ARB, countBuffer);
+
+	for (size_t r = 0; r < runs.size(); r++)
+	{
+		const void* offset = (void*)(sizeof(DrawCommand) * runs[r].firstGroup);
+		if (indirectCount) glMultiDrawElementsIndirectCountARB(GL_TRIANGLES, GL_UNSIGNED_INT, offset, (GLintptr)(sizeof(GLuint) * r), runs[r].groupCount, 0);
+		else               glMultiDrawElementsIndirect        (GL_TRIANGLES, GL_UNSIGNED_INT, offset, runs[r].groupCount, 0);
+	}
+}
+
+void GpuCuller::Unload()
+{
+	DeleteBuffers();
+	objectIndices.clear();
+	runs.clear();
+
+	glDeleteTextures(1, &depthTexture);
+	glDeleteTextures(1, &hiZTexture);
+	glDeleteFramebuffers(1, &depthFramebuffer);
+	depthTexture = hiZTexture = depthFramebuffer = 0;
+	depthWidth = depthHeight = 0;
+}
+
+// ===================================================================
+// GpuCuller private methods.
+// ===================================================================
+
+// Copy the scene depth and reduce it to a farthest depth pyramid.
+void GpuCuller::BuildHiZ()
+{
+	int width  = (int)FrameConstants::data.viewport[0];
+	int height = (int)FrameConstants::data.viewport[1];
+	if (width <= 0 || height <= 0) return;
+
+	int levels = 1 + (int)floor(log2(max(width, height)));
+	if (width != depthWidth || height != depthHeight)
+	{
+		glDeleteTextures(1, &depthTexture);
+		glDeleteTextures(1, &hiZTexture);
+		glDeleteFramebuffers(1, &depthFramebuffer);
+		GLState::Invalidate();
+
+		// Same format as the default framebuffer depth, required by the blit.
+		glCreateTextures(GL_TEXTURE_2D, 1, &depthTexture);
+		glTextureStorage2D(depthTexture, 1, GL_DEPTH24_STENCIL8, width, height);
+		glTextureParameteri(depthTexture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTextureParameteri(depthTexture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+		glCreateFramebuffers(1, &depthFramebuffer);
+		glNamedFramebufferTexture(depthFramebuffer, GL_DEPTH_STENCIL_ATTACHMENT, depthTexture, 0);
+
+		glCreateTextures(GL_TEXTURE_2D, 1, &hiZTexture);
+		glTextureStorage2D(hiZTexture, levels, GL_R32F, width, height);
+		glTextureParameteri(hiZTexture, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+		glTextureParameteri(hiZTexture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+		depthWidth  = width;
+		depthHeight = height;
+	}
+
+	// Models may be drawn in an offscreen target.
+	GLint sceneFramebuffer = 0;
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &sceneFramebuffer);
+	glBlitNamedFramebuffer(sceneFramebuffer, depthFramebuffer, 0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+
+	// Boxes are projected with this frame view when tested against the pyramid next frame.
+	memcpy(&hiZViewProj.m[0][0], FrameConstants::data.viewProj, sizeof(FrameConstants::data.viewProj));
+
+	GLState::UseProgram(hiZProgram);
+	Resources::Uniform<int> sourceLevel(hiZProgram, "sourceLevel");
+	for (int level = 0; level < levels; level++)
+	{
+		GLState::BindTextureUnit(GPU_HIZ_UNIT, level == 0 ? depthTexture : hiZTexture);
+		glBindImageTexture(0, hiZTexture, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+		sourceLevel.Set(level - 1);
+
+		glDispatchCompute((max(1, width >> level) + 7) / 8, (max(1, height >> level) + 7) / 8, 1);
+		glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+	}
+}
+
+void GpuCuller::DeleteBuffers()
+{
+	GLuint* buffers[] = { &transformBuffer, &objectBuffer, &templateBuffer, &commandBuffer, &visibleBuffer, &groupBuffer, &compactBuffer, &countBuffer };
+	for (GLuint* buffer : buffers)
+	{
+		glDeleteBuffers(1, buffer);
+		*buffer = 0;
+	}
+	GLState::Invalidate();
+}
\ No newline at end of file
@@ -0,0 +1,204 @@
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <Debug.h>
+#include <GpuProfiler.h>
+
+using namespace std;
+using namespace Core::Debug;
+using namespace Renderer;
+
+// GPU profiler static declaration.
+vector<GpuZoneResult>     GpuProfiler::zones;
+vector<GpuZoneHistory>    GpuProfiler::history;
+unsigned int              GpuProfiler::historyFrame    = 0;
+unsigned int              GpuProfiler::droppedFrames   = 0;
+vector<GpuFrameTime>      GpuProfiler::frameTimes;
+bool                      GpuProfiler::exportRequested = false;
+GpuProfiler::FrameQueries GpuProfiler::frames[GPU_PROFILER_LATENCY];
+unsigned int              GpuProfiler::frame = 0;
+vector<int>               GpuProfiler::openZones;
+
+// ===================================================================
+// GpuProfiler public methods.
+// ===================================================================
+
+void GpuProfiler::Init()
+{
+	if (frames[0].queries[0] != 0) return;
+
+	// Filled every frame, never reallocated.
+	zones  .reserve(GPU_PROFILER_MAX_ZONES);
+	history.reserve(GPU_PROFILER_MAX_ZONES);
+
+	for (FrameQueries& queries : frames)
+	{
+		glCreateQueries(GL_TIMESTAMP, GPU_PROFILER_MAX_ZONES * 2, queries.queries);
+		queries.count     = 0;
+		queries.lastQuery = -1;
+	}
+}
+
+void GpuProfiler::BeginFrame(const unsigned long long& index)
+{
+	frame++;
+	FrameQueries& queries = frames[frame % GPU_PROFILER_LATENCY];
+	if (queries.lastQuery >= 0) ReadBack(queries);
+
+	queries.count     = 0;
+	queries.lastQuery = -1;
+	queries.index     = index;
+	openZones.clear();
+}
+
+void GpuProfiler::Begin(const char* name)
+{
+	glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, name);
+
+	FrameQueries& queries = frames[frame % GPU_PROFILER_LATENCY];
+	if (queries.count == GPU_PROFILER_MAX_ZONES)
+	{
+		openZones.push_back(-1);
+		return;
+	}
+
+	unsigned int zone = queries.count++;
+	queries.names [zone] = name;
+	queries.depths[zone] = (unsigned int)openZones.size();
+	glQueryCounter(queries.queries[zone * 2], GL_TIMESTAMP);
+	openZones.push_back((int)zone);
+}
+
+void GpuProfiler::End()
+{
+	if (openZones.empty()) return;
+
+	int zone = openZones.back();
+	openZones.pop_back();
+
+	if (zone >= 0)
+	{
+		FrameQueries& queries = frames[frame % GPU_PROFILER_LATENCY];
+		glQueryCounter(queries.queries[zone * 2 + 1], GL_TIMESTAMP);
+		queries.lastQuery = zone * 2 + 1;
+	}
+
+	glPopDebugGroup();
+}
+
+// Oldest frame first, the current one included once all its zones ended.
+void GpuProfiler::Flush()
+{
+	glFinish();
+	for (unsigned int i = 1; i <= GPU_PROFILER_LATENCY; i++)
+	{
+		FrameQueries& queries = frames[(frame + i) % GPU_PROFILER_LATENCY];
+		if (queries.lastQuery < 0 || (i == GPU_PROFILER_LATENCY && !openZones.empty())) continue;
+
+		ReadBack(queries);
+		queries.count     = 0;
+		queries.lastQuery = -1;
+	}
+}
+
+void GpuProfiler::Unload()
+{
+	for (FrameQueries& queries : frames)
+	{
+		glDeleteQueries(GPU_PROFILER_MAX_ZONES * 2, queries.queries);
+		memset(queries.queries, 0, sizeof(queries.queries));
+		queries.count     = 0;
+		queries.lastQuery = -1;
+	}
+
+	zones.clear();
+	history.clear();
+	openZones.clear();
+}
+
+float GpuProfiler::GetMs(const char* name)
+{
+	return GetMs(zones, name);
+}
+
+float GpuProfiler::GetMs(const vector<GpuZoneResult>& results, const char* name)
+{
+	for (const GpuZoneResult& zone : results)
+		if (strcmp(zone.name, name) == 0) return zone.ms;
+	return 0;
+}
+
+// One line per history frame, oldest first, one column per zone.
+bool GpuProfiler::ExportCSV(const string& path, const vector<GpuZoneHistory>& zoneHistory, const unsigned int& oldestFrame)
+{
+	ofstream file(path);
+	if (!file.is_open())
+	{
+		Log(LogType::ERROR, "Could not write GPU profile to " + path + ".");
+		return false;
+	}
+
+	file << "frame";
+	for (const GpuZoneHistory& zone : zoneHistory) file << "," << zone.name;
+	file << "\n";
+
+	for (unsigned int i = 0; i < GPU_PROFILER_HISTORY; i++)
+	{
+		file << i;
+		for (const GpuZoneHistory& zone : zoneHistory) file << "," << zone.ms[(oldestFrame + i) % GPU_PROFILER_HISTORY];
+		file << "\n";
+	}
+
+	Log(LogType::INFO, "GPU profile of " + to_string(GPU_PROFILER_HISTORY) + " frames written to " + path + ".");
+	return true;
+}
+
+// ===================================================================
+// GpuProfiler private methods.
+// ===================================================================
+
+// Skip the frame rather than stall when the GPU is still behind.
+void GpuProfiler::ReadBack(FrameQueries& queries)
+{
+	GLint available = 0;
+	glGetQueryObjectiv(queries.queries[queries.lastQuery], GL_QUERY_RESULT_AVAILABLE, &available);
+	if (!available)
+	{
+		droppedFrames++;
+		return;
+	}
+
+	zones.clear();
+	for (GpuZoneHistory& zone : history) zone.ms[historyFrame] = 0;
+
+	GLuint64 frameBegin = ~0ull, frameEnd = 0;
+	for (unsigned int i = 0; i < queries.count; i++)
+	{
+		GLuint64 begin = 0, end = 0;
+		glGetQueryObjectui64v(queries.queries[i * 2],     GL_QUERY_RESULT, &begin);
+		glGetQueryObjectui64v(queries.queries[i * 2 + 1], GL_QUERY_RESULT, &end);
+		frameBegin = min(frameBegin, begin);
+		frameEnd   = max(frameEnd,   end);
+
+		GpuZoneResult result = { queries.names[i], queries.depths[i], end > begin ? (end - begin) / 1e6f : 0 };
+		zones.push_back(result);
+
+		// Zones are matched by name, new ones start with an empty history.
+		size_t entry = 0;
+		while (entry < history.size() && strcmp(history[entry].name, result.name) != 0) entry++;
+		if (entry == history.size())
+		{
+			if (entry == GPU_PROFILER_MAX_ZONES) continue;
+			history.push_back({ result.name, result.depth, {} });
+		}
+		history[entry].ms[historyFrame] = result.ms;
+	}
+
+	historyFrame = (historyFrame + 1) % GPU_PROFILER_HISTORY;
+	if (frameEnd > frameBegin) frameTimes.push_back({ queries.index, (frameEnd - frameBegin) / 1e6f });
+}
\ No newline at end of file
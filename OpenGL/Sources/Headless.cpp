@@ -0,0 +1,254 @@
+#include <glad/glad.h>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#ifdef HEADLESS_EGL
+#define EGL_NO_X11
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+#ifdef HEADLESS_OSMESA
+#include <GL/osmesa.h>
+#endif
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <Debug.h>
+#include <Vector3.h>
+#include <Camera.h>
+#include <CameraRecording.h>
+#include <Headless.h>
+
+using namespace std;
+using namespace Core;
+using namespace Core::Debug;
+using namespace Core::Maths;
+
+// Headless context static declaration.
+ContextAPI            HeadlessContext::api     = ContextAPI::Native;
+void*                 HeadlessContext::display = nullptr;
+void*                 HeadlessContext::context = nullptr;
+vector<unsigned char> HeadlessContext::buffer;
+
+// Unsigned option value, false when it is not a whole number.
+static bool ParseUnsigned(const string& value, unsigned int& result)
+{
+	istringstream stream(value);
+	return (stream >> result) && stream.eof();
+}
+
+// ===================================================================
+// CameraPath public methods.
+// ===================================================================
+
+bool CameraPath::Load(const string& path)
+{
+	ifstream file(path);
+	if (!file.is_open())
+	{
+		Log(LogType::ERROR, "Could not open camera path " + path + ".");
+		return false;
+	}
+
+	m_keys.clear();
+	string line;
+	for (unsigned int number = 1; getline(file, line); number++)
+	{
+		if (line.empty() || line[0] == '#') continue;
+
+		CameraKey key;
+		istringstream stream(line);
+		if (!(stream >> key.time >> key.position.x >> key.position.y >> key.position.z >> key.pitch >> key.yaw))
+		{
+			Log(LogType::ERROR, "Invalid camera key at " + path + ":" + to_string(number) + ".");
+			return false;
+		}
+		m_keys.push_back(key);
+	}
+
+	// Keys may be written in any order.
+	sort(m_keys.begin(), m_keys.end(), [](const CameraKey& a, const CameraKey& b) { return a.time < b.time; });
+
+	if (m_keys.empty()) Log(LogType::WARNING, "Camera path " + path + " has no key.");
+	return !m_keys.empty();
+}
+
+bool  CameraPath::IsEmpty()     const { return m_keys.empty(); }
+float CameraPath::GetDuration() const { return m_keys.empty() ? 0 : m_keys.back().time; }
+
+// Clamped to the first and last keys.
+void CameraPath::Apply(Renderer::Camera& camera, const float& time) const
+{
+	if (m_keys.empty()) return;
+
+	size_t next = 0;
+	while (next < m_keys.size() && m_keys[next].time <= time) next++;
+
+	const CameraKey& a = m_keys[next == 0 ? 0 : next - 1];
+	const CameraKey& b = m_keys[min(next, m_keys.size() - 1)];
+	float t = b.time > a.time ? (time - a.time) / (b.time - a.time) : 0;
+
+	camera.SetPosition(a.position + (b.position - a.position) * t);
+	camera.SetRotation(a.pitch + (b.pitch - a.pitch) * t, a.yaw + (b.yaw - a.yaw) * t);
+}
+
+// ===================================================================
+// HeadlessContext public methods.
+// ===================================================================
+
+// Versions and names are unused by builds without any headless API.
+bool HeadlessContext::Create(const HeadlessSettings& settings, [[maybe_unused]] const int& glVersionMajor, [[maybe_unused]] const int& glVersionMinor)
+{
+	api = settings.api;
+
+#ifdef HEADLESS_EGL
+	if (api == ContextAPI::EGL)
+	{
+		// Surfaceless platform: no window system, not even a pbuffer.
+		PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+		EGLDisplay eglDisplay = getPlatformDisplay ? getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr) : EGL_NO_DISPLAY;
+		if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, nullptr, nullptr))
+		{
+			Log(LogType::ERROR, "EGL surfaceless platform is not available.");
+			return false;
+		}
+		display = eglDisplay;
+
+		const EGLint attributes[] = { EGL_CONTEXT_MAJOR_VERSION, glVersionMajor, EGL_CONTEXT_MINOR_VERSION, glVersionMinor,
+									  EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT, EGL_CONTEXT_OPENGL_DEBUG, EGL_TRUE, EGL_NONE };
+		eglBindAPI(EGL_OPENGL_API);
+		context = eglCreateContext(eglDisplay, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attributes);
+		if (context == EGL_NO_CONTEXT || !eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, (EGLContext)context))
+		{
+			Log(LogType::ERROR, "Could not create an EGL " + to_string(glVersionMajor) + "." + to_string(glVersionMinor) + " core context.");
+			Destroy();
+			return false;
+		}
+		return true;
+	}
+#endif
+
+#ifdef HEADLESS_OSMESA
+	if (api == ContextAPI::OSMesa)
+	{
+		const int attributes[] = { OSMESA_FORMAT, OSMESA_RGBA, OSMESA_DEPTH_BITS, 24, OSMESA_STENCIL_BITS, 8, OSMESA_PROFILE, OSMESA_CORE_PROFILE,
+								   OSMESA_CONTEXT_MAJOR_VERSION, glVersionMajor, OSMESA_CONTEXT_MINOR_VERSION, glVersionMinor, 0 };
+		context = OSMesaCreateContextAttribs(attributes, NULL);
+
+		buffer.resize((size_t)settings.width * settings.height * 4);
+		if (context == nullptr || !OSMesaMakeCurrent((OSMesaContext)context, buffer.data(), GL_UNSIGNED_BYTE, settings.width, settings.height))
+		{
+			Log(LogType::ERROR, "Could not create an OSMesa " + to_string(glVersionMajor) + "." + to_string(glVersionMinor) + " core context.");
+			Destroy();
+			return false;
+		}
+		return true;
+	}
+#endif
+
+	Log(LogType::ERROR, "This build does not support the requested headless context API, rebuild with HEADLESS_EGL or HEADLESS_OSMESA or use --api=native.");
+	return false;
+}
+
+void* HeadlessContext::GetProcAddress([[maybe_unused]] const char* name)
+{
+#ifdef HEADLESS_EGL
+	if (api == ContextAPI::EGL) return (void*)eglGetProcAddress(name);
+#endif
+#ifdef HEADLESS_OSMESA
+	if (api == ContextAPI::OSMesa) return (void*)OSMesaGetProcAddress(name);
+#endif
+	return nullptr;
+}
+
+void HeadlessContext::Destroy()
+{
+#ifdef HEADLESS_EGL
+	if (api == ContextAPI::EGL && display != nullptr)
+	{
+		eglMakeCurrent((EGLDisplay)display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		if (context != nullptr) eglDestroyContext((EGLDisplay)display, (EGLContext)context);
+		eglTerminate((EGLDisplay)display);
+	}
+#endif
+#ifdef HEADLESS_OSMESA
+	if (api == ContextAPI::OSMesa && context != nullptr) OSMesaDestroyContext((OSMesaContext)context);
+#endif
+
+	display = context = nullptr;
+	buffer.clear();
+}
+
+// ===================================================================
+// Headless public methods.
+// ===================================================================
+
+bool Headless::ParseArguments(const int& argc, char** argv, HeadlessSettings& settings)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		string argument = argv[i];
+		size_t equal    = argument.find('=');
+		string option   = argument.substr(0, equal);
+		string value    = equal == string::npos ? "" : argument.substr(equal + 1);
+
+		bool valid = true;
+		if      (option == "--headless")    settings.enabled = true;
+		else if (option == "--frames")      valid = ParseUnsigned(value, settings.frames) && settings.frames > 0;
+		else if (option == "--save-every")  valid = ParseUnsigned(value, settings.saveInterval) && settings.saveInterval > 0;
+		else if (option == "--camera-path") settings.cameraPath      = value;
+		else if (option == "--output")      settings.outputDirectory = value;
+		else if (option == "--benchmark")   settings.benchmarkPath   = value.empty() ? CAMERA_RECORDING_PATH : value;
+		else if (option == "--size")
+		{
+			size_t x = value.find('x');
+			unsigned int width = 0, height = 0;
+			valid = x != string::npos && ParseUnsigned(value.substr(0, x), width) && ParseUnsigned(value.substr(x + 1), height) && width > 0 && height > 0;
+			settings.width  = (int)width;
+			settings.height = (int)height;
+		}
+		else if (option == "--api")
+		{
+			if      (value == "native") settings.api = ContextAPI::Native;
+			else if (value == "egl")    settings.api = ContextAPI::EGL;
+			else if (value == "osmesa") settings.api = ContextAPI::OSMesa;
+			else valid = false;
+		}
+		else valid = false;
+
+		if (!valid)
+		{
+			Log(LogType::ERROR, "Invalid option " + argument + ". Usage: --headless [--api=osmesa|egl|native] [--size=WxH] [--frames=N] "
+								"[--camera-path=file] [--output=directory] [--save-every=N] [--benchmark[=recording]]");
+			return false;
+		}
+	}
+	return true;
+}
+
+// Read back synchronously, only meant for headless runs.
+bool Headless::SaveFrame(const GLuint& framebuffer, const int& width, const int& height, const string& path)
+{
+	vector<unsigned char> pixels((size_t)width * height * 4);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glNamedFramebufferReadBuffer(framebuffer, GL_COLOR_ATTACHMENT0);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+	glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+	// GL rows start at the bottom.
+	error_code error;
+	filesystem::create_directories(filesystem::path(path).parent_path(), error);
+	stbi_flip_vertically_on_write(1);
+	if (!stbi_write_png(path.c_str(), width, height, 4, pixels.data(), width * 4))
+	{
+		Log(LogType::ERROR, "Could not write frame to " + path + ".");
+		return false;
+	}
+	return true;
+}
\ No newline at end of file
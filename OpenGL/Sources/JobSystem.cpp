@@ -0,0 +1,283 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include <Debug.h>
+#include <CpuProfiler.h>
+#include <JobSystem.h>
+
+using namespace std;
+using namespace Core;
+
+// Job system static declaration.
+vector<JobThreadTrace>   JobSystem::trace;
+unsigned int             JobSystem::traceFrame  = 0;
+JobSystem::ThreadData*   JobSystem::threads     = nullptr;
+vector<thread>           JobSystem::workers;
+atomic<unsigned int>     JobSystem::threadCount = 0;
+atomic<unsigned int>     JobSystem::queued      = 0;
+atomic<bool>             JobSystem::running     = false;
+double                   JobSystem::frameStart  = 0;
+
+static thread_local int          threadIndex = -1; // Registered threads deque, -1 for others.
+static thread_local unsigned int jobDepth    = 0;  // Nested jobs are timed by the outer one.
+static mutex                     sleepMutex;
+static condition_variable        wakeUp;
+
+static double GetSeconds()
+{
+	return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ===================================================================
+// JobDeque methods.
+// ===================================================================
+
+bool JobDeque::Push(Job* job)
+{
+	int64_t bottom = m_bottom.load(memory_order_relaxed);
+	int64_t top    = m_top.load(memory_order_acquire);
+	if (bottom - top >= JOB_DEQUE_CAPACITY) return false;
+
+	// Released with the bottom: thieves see the job content once they see it in the deque.
+	m_jobs[bottom & (JOB_DEQUE_CAPACITY - 1)].store(job, memory_order_relaxed);
+	m_bottom.store(bottom + 1, memory_order_release);
+	return true;
+}
+
+Job* JobDeque::Pop()
+{
+	int64_t bottom = m_bottom.load(memory_order_relaxed) - 1;
+	m_bottom.store(bottom, memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);
+	int64_t top = m_top.load(memory_order_relaxed);
+
+	if (top > bottom)
+	{
+		m_bottom.store(bottom + 1, memory_order_relaxed);
+		return nullptr;
+	}
+
+	// Last job: race the thieves for it.
+	Job* job = m_jobs[bottom & (JOB_DEQUE_CAPACITY - 1)].load(memory_order_relaxed);
+	if (top == bottom)
+	{
+		if (!m_top.compare_exchange_strong(top, top + 1, memory_order_seq_cst, memory_order_relaxed)) job = nullptr;
+		m_bottom.store(bottom + 1, memory_order_relaxed);
+	}
+	return job;
+}
+
+Job* JobDeque::Steal()
+{
+	int64_t top = m_top.load(memory_order_acquire);
+	atomic_thread_fence(memory_order_seq_cst);
+	int64_t bottom = m_bottom.load(memory_order_acquire);
+	if (top >= bottom) return nullptr;
+
+	Job* job = m_jobs[top & (JOB_DEQUE_CAPACITY - 1)].load(memory_order_relaxed);
+	if (!m_top.compare_exchange_strong(top, top + 1, memory_order_seq_cst, memory_order_relaxed)) return nullptr;
+	return job;
+}
+
+// ===================================================================
+// JobSystem public methods.
+// ===================================================================
+
+void JobSystem::Init()
+{
+	if (threads != nullptr) return;
+
+	// The main thread takes part in the work, one core is left to it.
+	unsigned int workerCount = min(max(thread::hardware_concurrency(), 1u) - 1, (unsigned int)JOB_MAX_WORKERS);
+	threads = new ThreadData[workerCount + JOB_EXTERNAL_THREADS];
+	trace.assign(workerCount + JOB_EXTERNAL_THREADS, JobThreadTrace());
+	threadCount = workerCount;
+	running     = true;
+	frameStart  = GetSeconds();
+
+	for (unsigned int i = 0; i < workerCount; i++)
+		workers.push_back(thread(WorkerLoop, i));
+
+	RegisterThread();
+}
+
+void JobSystem::RegisterThread()
+{
+	if (threadIndex >= 0) return;
+
+	unsigned int index = threadCount++;
+	Assert(index < workers.size() + JOB_EXTERNAL_THREADS, "Too many threads registered to the job system.");
+	threadIndex = (int)index;
+}
+
+void JobSystem::Run(JobCounter& counter, const function<void()>& task)
+{
+	counter.pending.fetch_add(1, memory_order_relaxed);
+
+	// Without workers or deque, or while the next pool slot is still live, the job runs right away.
+	ThreadData* data = threadIndex >= 0 && !workers.empty() ? &threads[threadIndex] : nullptr;
+	Job* job = data != nullptr ? &data->jobs[data->nextJob % JOB_POOL_SIZE] : nullptr;
+	if (job == nullptr || job->live.load(memory_order_acquire))
+	{
+		task();
+		counter.pending.fetch_sub(1, memory_order_release);
+		return;
+	}
+
+	data->nextJob++;
+	job->task    = task;
+	job->counter = &counter;
+	job->live.store(true, memory_order_relaxed);
+
+	if (!data->deque.Push(job))
+	{
+		Execute(job, threadIndex);
+		return;
+	}
+
+	queued.fetch_add(1, memory_order_release);
+	wakeUp.notify_one();
+}
+
+// Split [0, count) in grain sized ranges, the calling thread runs the first one then helps with the others.
+void JobSystem::ParallelFor(const size_t& count, const size_t& grain, const function<void(const size_t& begin, const size_t& end)>& task)
+{
+	if (count == 0) return;
+
+	size_t step = max(grain, (size_t)1);
+	JobCounter counter;
+	for (size_t begin = step; begin < count; begin += step)
+		Run(counter, [&task, begin, step, count]() { task(begin, min(count, begin + step)); });
+
+	task(0, min(count, step));
+	Wait(counter);
+}
+
+void JobSystem::Wait(JobCounter& counter)
+{
+	while (counter.pending.load(memory_order_acquire) > 0)
+	{
+		Job* job = threadIndex >= 0 ? GetJob(threadIndex) : nullptr;
+		if (job != nullptr) Execute(job, threadIndex);
+		else                this_thread::yield();
+	}
+}
+
+void JobSystem::EndFrame()
+{
+	double now = GetSeconds();
+	double frameNs = max(now - frameStart, 1e-6) * 1e9;
+	frameStart = now;
+
+	for (size_t i = 0; i < trace.size(); i++)
+	{
+		uint64_t busyNs = threads[i].busyNs.exchange(0, memory_order_relaxed);
+		trace[i].utilization[traceFrame] = min(1.f, (float)(busyNs / frameNs));
+		trace[i].busyMs = busyNs / 1e6f;
+		trace[i].jobs   = threads[i].executed.exchange(0, memory_order_relaxed);
+		trace[i].steals = threads[i].stolen  .exchange(0, memory_order_relaxed);
+	}
+
+	traceFrame = (traceFrame + 1) % JOB_TRACE_FRAMES;
+}
+
+void JobSystem::Unload()
+{
+	running = false;
+	wakeUp.notify_all();
+	for (thread& worker : workers) worker.join();
+	workers.clear();
+
+	delete[] threads;
+	threads = nullptr;
+	trace.clear();
+	threadCount = 0;
+	threadIndex = -1;
+}
+
+unsigned int JobSystem::GetWorkerCount()
+{
+	return (unsigned int)workers.size();
+}
+
+// ===================================================================
+// JobSystem private methods.
+// ===================================================================
+
+// Own jobs first, newest first for cache locality, then steal the oldest job of another thread.
+Job* JobSystem::GetJob(const unsigned int& self)
+{
+	Job* job = threads[self].deque.Pop();
+	if (job == nullptr)
+	{
+		static thread_local unsigned int seed = self * 2654435761u + 1;
+		unsigned int count = threadCount.load(memory_order_relaxed);
+
+		seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5;
+		for (unsigned int i = 0; i < count && job == nullptr; i++)
+		{
+			unsigned int victim = (seed + i) % count;
+			if (victim != self) job = threads[victim].deque.Steal();
+		}
+
+		if (job != nullptr) threads[self].stolen.fetch_add(1, memory_order_relaxed);
+	}
+
+	if (job != nullptr) queued.fetch_sub(1, memory_order_relaxed);
+	return job;
+}
+
+void JobSystem::Execute(Job* job, const unsigned int& self)
+{
+	PROFILE_ZONE("Job");
+
+	JobCounter* counter = job->counter;
+	double start = jobDepth == 0 ? GetSeconds() : 0;
+
+	jobDepth++;
+	job->task();
+	jobDepth--;
+
+	if (jobDepth == 0) threads[self].busyNs.fetch_add((uint64_t)((GetSeconds() - start) * 1e9), memory_order_relaxed);
+	threads[self].executed.fetch_add(1, memory_order_relaxed);
+	counter->pending.fetch_sub(1, memory_order_release);
+
+	// The owner may now reassign the slot task.
+	job->live.store(false, memory_order_release);
+}
+
+// Spin briefly between jobs, then sleep until one is pushed.
+void JobSystem::WorkerLoop(const unsigned int& index)
+{
+	threadIndex = (int)index;
+	PROFILE_THREAD("Worker " + to_string(index));
+
+	unsigned int idle = 0;
+	while (running.load(memory_order_relaxed))
+	{
+		Job* job = GetJob(index);
+		if (job != nullptr)
+		{
+			Execute(job, index);
+			idle = 0;
+			continue;
+		}
+
+		if (++idle < 64)
+		{
+			this_thread::yield();
+			continue;
+		}
+
+		// Timed wait: a push racing with the check only delays the worker.
+		unique_lock<mutex> lock(sleepMutex);
+		wakeUp.wait_for(lock, chrono::milliseconds(1), []() { return queued.load(memory_order_acquire) > 0 || !running.load(memory_order_relaxed); });
+	}
+}
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include <GLFW/glfw3.h>
 
 #include <Vector3.h>
+#include <Vector4.h>
 #include <ResourceManager.h>
 #include <Light.h>
 
@@ -73,12 +74,14 @@ Light::Light(const Maths::Vector3& ambient,
 			 const Maths::Vector3& position,
 			 const Maths::Vector3& direction,
 			 const float& innerCone,
-			 const float& outerCone)
+			 const float& outerCone,
+			 const float& range)
 	: m_ambient(ambient)
 	, m_diffuse(diffuse)
 	, m_specular(specular)
+	, m_position(position)
 	, m_direction(direction)
-	, m_range(0)
+	, m_range(range)
 	, m_linear(0)
 	, m_quadratic(0)
 	, m_innerCone(innerCone)
@@ -107,17 +110,14 @@ void Light::operator=(const Light& light)
 // Light main method.
 // ===================================================================
 
-void Light::UpdateShader(const unsigned int& id)
+// Pack light fields to their GPU layout.
+LightData Light::GetData() const
 {
-	glUniform3fv(glGetUniformLocation(ResourceManager::shaderProgram, string("lights[" + to_string(id) + "].ambient").c_str()),   1, &m_ambient.x);
-	glUniform3fv(glGetUniformLocation(ResourceManager::shaderProgram, string("lights[" + to_string(id) + "].diffuse").c_str()),   1, &m_diffuse.x);
-	glUniform3fv(glGetUniformLocation(ResourceManager::shaderProgram, string("lights[" + to_string(id) + "].specular").c_str()),  1, &m_specular.x);
-	glUniform3fv(glGetUniformLocation(ResourceManager::shaderProgram, string("lights[" + to_string(id) + "].position").c_str()),  1, &m_position.x);
-	glUniform3fv(glGetUniformLocation(ResourceManager::shaderProgram, string("lights[" + to_string(id) + "].direction").c_str()), 1, &m_direction.x);
-
-	glUniform1f (glGetUniformLocation(ResourceManager::shaderProgram, string("lights[" + to_string(id) + "].range").c_str()),     m_range);
-	glUniform1f (glGetUniformLocation(ResourceManager::shaderProgram, string("lights[" + to_string(id) + "].linear").c_str()),    m_linear);
-	glUniform1f (glGetUniformLocation(ResourceManager::shaderProgram, string("lights[" + to_string(id) + "].quadratic").c_str()), m_quadratic);
-	glUniform1f (glGetUniformLocation(ResourceManager::shaderProgram, string("lights[" + to_string(id) + "].innerCone").c_str()), m_innerCone);
-	glUniform1f (glGetUniformLocation(ResourceManager::shaderProgram, string("lights[" + to_string(id) + "].outerCone").c_str()), m_outerCone);
+	return {
+		Maths::Vector4(m_ambient.x,   m_ambient.y,   m_ambient.z,   m_range),
+		Maths::Vector4(m_diffuse.x,   m_diffuse.y,   m_diffuse.z,   m_linear),
+		Maths::Vector4(m_specular.x,  m_specular.y,  m_specular.z,  m_quadratic),
+		Maths::Vector4(m_position.x,  m_position.y,  m_position.z,  m_innerCone),
+		Maths::Vector4(m_direction.x, m_direction.y, m_direction.z, m_outerCone)
+	};
 }
\ No newline at end of file
@@ -1,30 +1,194 @@
+#include <cstring>
 #include <vector>
+#include <algorithm>
 
 #include <Light.h>
 #include <ResourceManager.h>
+#include <FrameRing.h>
+#include <JobSystem.h>
+#include <GLState.h>
 #include <LightManager.h>
 
 using namespace std;
 using namespace Core;
 using namespace Renderer;
 
-Light LightManager::lights[MAX_LIGHTS];
+// Light manager static declaration.
+vector<Light> LightManager::lights;
+GLuint        LightManager::buffer = 0, LightManager::clustersBuffer = 0, LightManager::clusterLightsBuffer = 0;
+GLuint        LightManager::assignProgram = 0;
+unsigned int  LightManager::capacity   = 0;
+bool          LightManager::countDirty = true;
+vector<bool>  LightManager::dirty;
+
+// ===================================================================
+// LightManager public methods.
+// ===================================================================
 
 void LightManager::Init()
 {
-	for (int i = 0; i < MAX_LIGHTS; i++) lights[i] = Light();
+	if (assignProgram == 0)
+		assignProgram = Resources::ResourceManager::CreateProgram({ { "Assets/Shaders/AssignLights.comp", Resources::ShaderType::ComputeShader } });
+
+	// Per cluster light range (offset, count), then a shared list of light indices behind an allocation counter.
+	if (clustersBuffer == 0)
+	{
+		glCreateBuffers(1, &clustersBuffer);
+		glNamedBufferStorage(clustersBuffer, sizeof(unsigned int) * 2 * CLUSTER_COUNT, nullptr, 0);
+		glCreateBuffers(1, &clusterLightsBuffer);
+		glNamedBufferStorage(clusterLightsBuffer, sizeof(unsigned int) * (1 + CLUSTER_COUNT * CLUSTER_LIGHTS_BUDGET), nullptr, GL_DYNAMIC_STORAGE_BIT);
+	}
+
+	lights.clear();
+	dirty.clear();
+	Reserve(16);
+	countDirty = true;
 }
 
 void LightManager::SetLight(const Renderer::Light& light, const unsigned int& id)
 {
-	if (id < MAX_LIGHTS)
-		lights[id] = light;
+	if (id >= lights.size())
+	{
+		lights.resize(id + 1);
+		dirty.resize(id + 1, true);
+		countDirty = true;
+	}
+
+	lights[id] = light;
+	dirty[id]  = true;
+}
+
+unsigned int LightManager::AddLight(const Renderer::Light& light)
+{
+	unsigned int id = (unsigned int)lights.size();
+	SetLight(light, id);
+	return id;
+}
+
+void LightManager::Clear(const unsigned int& first)
+{
+	if (first >= lights.size()) return;
+
+	lights.resize(first);
+	dirty.resize(first);
+	countDirty = true;
+}
+
+bool LightManager::HasChanges()
+{
+	return countDirty || find(dirty.begin(), dirty.end(), true) != dirty.end();
+}
+
+// Gather the lights changed since the last call, without any GL call.
+void LightManager::Collect(LightSnapshot& output)
+{
+	output.count        = (unsigned int)lights.size();
+	output.countChanged = countDirty;
+	output.ids.clear();
+	output.data.clear();
+
+	for (size_t i = 0; i < lights.size(); i++)
+	{
+		if (!dirty[i]) continue;
+
+		output.ids.push_back((unsigned int)i);
+		dirty[i] = false;
+	}
+
+	// Changed lights are packed to their shader layout by ranges.
+	output.data.resize(output.ids.size());
+	Core::JobSystem::ParallelFor(output.ids.size(), JOB_GRAIN, [&output](const size_t& first, const size_t& last)
+	{
+		for (size_t i = first; i < last; i++) output.data[i] = lights[output.ids[i]].GetData();
+	});
+
+	countDirty = false;
+}
+
+// Upload changed lights, bind the lights buffers and assign lights to clusters, once per frame.
+// Changes are staged in the frame ring and copied on the GPU timeline, never waiting for lights still in use.
+void LightManager::Upload(const LightSnapshot& changes, const bool& assignClusters)
+{
+	Reserve(changes.count);
+
+	if (changes.countChanged)
+	{
+		RingAllocation staging = FrameRing::Allocate(sizeof(LightsHeader), sizeof(unsigned int));
+		*(LightsHeader*)staging.data = { changes.count, { 0, 0, 0 } };
+		glCopyNamedBufferSubData(staging.buffer, buffer, staging.offset, 0, sizeof(LightsHeader));
+	}
+
+	if (!changes.ids.empty())
+	{
+		RingAllocation staging = FrameRing::Allocate(sizeof(LightData) * changes.ids.size(), sizeof(float) * 4);
+		memcpy(staging.data, changes.data.data(), sizeof(LightData) * changes.ids.size());
+
+		// One copy per contiguous range of changed lights.
+		for (size_t i = 0; i < changes.ids.size();)
+		{
+			size_t first = i++;
+			while (i < changes.ids.size() && changes.ids[i] == changes.ids[i - 1] + 1) i++;
+
+			glCopyNamedBufferSubData(staging.buffer, buffer, staging.offset + sizeof(LightData) * first,
+				sizeof(LightsHeader) + sizeof(LightData) * changes.ids[first], sizeof(LightData) * (i - first));
+		}
+	}
+
+	GLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, LIGHTS_BINDING,         buffer);
+	GLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, CLUSTERS_BINDING,       clustersBuffer);
+	GLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, CLUSTER_LIGHTS_BINDING, clusterLightsBuffer);
+
+	if (assignClusters) AssignLights();
+}
+
+void LightManager::Unload()
+{
+	glDeleteBuffers(1, &buffer);
+	glDeleteBuffers(1, &clustersBuffer);
+	glDeleteBuffers(1, &clusterLightsBuffer);
+	buffer = clustersBuffer = clusterLightsBuffer = 0;
+	capacity = 0;
+
+	lights.clear();
+	dirty.clear();
+}
+
+// ===================================================================
+// LightManager private methods.
+// ===================================================================
+
+// Grow the lights buffer to hold at least count lights, its content is copied on the GPU timeline.
+void LightManager::Reserve(const unsigned int& count)
+{
+	if (count <= capacity && buffer != 0) return;
+
+	unsigned int oldCapacity = capacity;
+	while (capacity < count) capacity = capacity == 0 ? 16 : capacity * 2;
+
+	GLuint oldBuffer = buffer;
+	glCreateBuffers(1, &buffer);
+	glNamedBufferStorage(buffer, sizeof(LightsHeader) + sizeof(LightData) * capacity, nullptr, 0);
+
+	if (oldBuffer != 0)
+	{
+		glCopyNamedBufferSubData(oldBuffer, buffer, 0, 0, sizeof(LightsHeader) + sizeof(LightData) * oldCapacity);
+		glDeleteBuffers(1, &oldBuffer);
+		GLState::Invalidate();
+	}
 	else
-		Log(Debug::LogType::WARNING, string("Could'nt add more lights (MAX_LIGHTS set to ") + to_string(MAX_LIGHTS) + ").");
+	{
+		const unsigned int zero = 0;
+		glClearNamedBufferSubData(buffer, GL_R32UI, 0, sizeof(unsigned int), GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+	}
 }
 
-void LightManager::Update()
+// One thread per view frustum cluster gathers the lights overlapping it, read by the fragment shader.
+void LightManager::AssignLights()
 {
-	for (int i = 0; i < MAX_LIGHTS; i++)
-		lights[i].UpdateShader(i);
+	const unsigned int zero = 0;
+	glClearNamedBufferSubData(clusterLightsBuffer, GL_R32UI, 0, sizeof(unsigned int), GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+
+	GLState::UseProgram(assignProgram);
+	glDispatchCompute((CLUSTER_COUNT + 127) / 128, 1, 1);
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
 }
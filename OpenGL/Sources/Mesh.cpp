@@ -1,6 +1,7 @@
 #include <Debug.h>
 #include <Vector2.h>
 #include <Vector3.h>
+#include <CpuProfiler.h>
 #include <ParserOBJ.h>
 #include <ResourceManager.h>
 #include <Mesh.h>
@@ -13,7 +14,7 @@ using namespace Resources;
 // Mesh constructor.
 // ===================================================================
 
-Mesh::Mesh() : VAO(0), VBO(0), EBO(0), texture(nullptr), data() { }
+Mesh::Mesh() : range({ 0, 0, 0, 0 }), texture(nullptr), data() { }
 
 Mesh::Mesh(const char* objectPath, const char* texturePath)
 {
@@ -27,13 +28,18 @@ Mesh::Mesh(const char* objectPath, const char* texturePath)
 
 void Mesh::Create(const char* path)
 {
+	PROFILE_FUNCTION();
+
     ParserOBJ parser;
     data = parser.ParseInputFile(path);
 	
 	InitBuffers();
 
+	// Occluders are rasterized on the CPU from positions and indices only.
+	positions.reserve(data.vertices.size());
+	for (const Maths::Vertex& vertex : data.vertices) positions.push_back(vertex.pos);
+
     data.vertices.clear();
-    data.indices.clear();
 }
 
 void Mesh::Unload() { }
@@ -49,26 +55,5 @@ void Mesh::InitTexture(const char* path)
 
 void Mesh::InitBuffers()
 {
-    glCreateBuffers(1, &VBO);	
-	glNamedBufferStorage(VBO, sizeof(Maths::Vertex) * data.vertices.size(), data.vertices.data(), GL_DYNAMIC_STORAGE_BIT);
-
-	glCreateBuffers(1, &EBO);
-	glNamedBufferStorage(EBO, sizeof(uint32_t) * data.indices.size(), data.indices.data(), GL_DYNAMIC_STORAGE_BIT);
-
-	glCreateVertexArrays(1, &VAO);
-
-	glVertexArrayVertexBuffer(VAO, 0, VBO, 0, sizeof(Maths::Vertex));
-	glVertexArrayElementBuffer(VAO, EBO);
-
-	glEnableVertexArrayAttrib(VAO, 0);
-	glEnableVertexArrayAttrib(VAO, 1);
-	glEnableVertexArrayAttrib(VAO, 2);
-
-	glVertexArrayAttribFormat(VAO, 0, 3, GL_FLOAT, GL_FALSE, offsetof(Maths::Vertex, Maths::Vertex::pos));
-	glVertexArrayAttribFormat(VAO, 1, 2, GL_FLOAT, GL_FALSE, offsetof(Maths::Vertex, Maths::Vertex::uv));
-	glVertexArrayAttribFormat(VAO, 2, 3, GL_FLOAT, GL_FALSE, offsetof(Maths::Vertex, Maths::Vertex::normal));
-
-	glVertexArrayAttribBinding(VAO, 0, 0);
-	glVertexArrayAttribBinding(VAO, 1, 0);
-	glVertexArrayAttribBinding(VAO, 2, 0);
+	range = GeometryPool::Add(data.vertices, data.indices);
 }
\ No newline at end of file
@@ -1,23 +1,202 @@
+#include <cstring>
+#include <algorithm>
+#include <vector>
+
 #include <Mesh.h>
+#include <GeometryPool.h>
 #include <Model.h>
 #include <Camera.h>
+#include <Uniform.h>
+#include <RenderQueue.h>
+#include <FrustumCuller.h>
+#include <GpuCuller.h>
+#include <FrameRing.h>
+#include <CommandBuffer.h>
+#include <GpuProfiler.h>
+#include <CpuProfiler.h>
 #include <SceneNode.h>
 #include <SceneGraph.h>
+#include <ResourceManager.h>
 #include <ModelManager.h>
 
 using namespace std;
 using namespace Core::Scene;
 using namespace Renderer;
 
+// ===================================================================
+// ModelManager public methods.
+// ===================================================================
+
+void ModelManager::Init(const GLuint& _program)
+{
+	program = _program;
+
+	// Texture unit never changes.
+	Resources::Uniform<int>(program, "tex").Set(1);
+}
+
 void ModelManager::AddModel(string name, const char* objPath, const char* ambientPath)
 {
 	models[name] = new Model(name.c_str(), objPath, ambientPath);
 	SceneGraph::AddNode(string(name), models[name]);
+	gpuSceneDirty = true;
+}
+
+void ModelManager::BeginOcclusion(const Camera& camera)
+{
+	if (!occlusionCulling || gpuCulling) return;
+
+	// A rasterization left by a frame culled on the GPU still uses the occluders.
+	Core::JobSystem::Wait(occlusionJob);
+	occlusion.Begin(camera.GetVPMat(), camera.GetNearDistance());
+	for (auto& it : models)
+	{
+		if (!it.second->IsOccluder()) continue;
+
+		Resources::Mesh* mesh = it.second->GetMesh();
+		occlusion.AddOccluder(mesh->positions, mesh->data.indices, it.second->GetData()->mat);
+	}
+
+	// Rasterized by the job system while the frame goes on.
+	occlusionStarted = true;
+	Core::JobSystem::Run(occlusionJob, []() { occlusion.Rasterize(); });
 }
 
-void ModelManager::DrawModels(const Camera& camera, const GLuint& sampler)
+// Cull the models and lay out the draws of the visible ones, without any GL call.
+void ModelManager::BuildDraws(const Camera& camera, DrawSnapshot& output)
 {
-	for (auto& it : models) it.second->Draw(camera, sampler);
+	PROFILE_FUNCTION();
+
+	output.gpuCulling       = gpuCulling;
+	output.hiZCulling       = GpuCuller::hiZCulling;
+	output.validateCommands = validateCommands;
+	output.rebuildGpuScene  = false;
+	output.objects.clear();
+	output.batches.clear();
+	output.instances.clear();
+	output.moved.clear();
+
+	if (gpuCulling)
+	{
+		// Rebuild the GPU scene when models were added, otherwise only send moved transforms.
+		output.rebuildGpuScene = gpuSceneDirty;
+		if (gpuSceneDirty)
+		{
+			output.objects.reserve(models.size());
+			for (auto& it : models)
+			{
+				output.objects.push_back({ it.second, it.second->GetMesh(), it.second->GetMesh()->data.bounds, {} });
+				memcpy(output.objects.back().transform.model, &it.second->GetData()->mat.m[0][0], sizeof(InstanceData));
+			}
+		}
+		else
+		{
+			const vector<SceneNode*>& moved = SceneGraph::movedNodes;
+			output.moved.resize(moved.size());
+			Core::JobSystem::ParallelFor(moved.size(), JOB_GRAIN, [&](const size_t& first, const size_t& last)
+			{
+				for (size_t i = first; i < last; i++)
+				{
+					output.moved[i].first = moved[i];
+					memcpy(output.moved[i].second.model, &moved[i]->GetData()->mat.m[0][0], sizeof(InstanceData));
+				}
+			});
+		}
+		gpuSceneDirty = false;
+		SceneGraph::ClearMoved();
+
+		// Visibility stays on the GPU, every object is tested.
+		cullingStats   = { 0, 0, (unsigned int)models.size() };
+		occlusionStats = { 0, 0, 0, 0 };
+		return;
+	}
+
+	// Moves are not sent to the GPU scene meanwhile, it is rebuilt once GPU culling is enabled again.
+	gpuSceneDirty = true;
+	SceneGraph::ClearMoved();
+
+	Cull(camera);
+	BuildQueue(camera);
+	BuildBatches(output);
+}
+
+// Upload the draws of a snapshot, which can then be submitted by several passes.
+void ModelManager::UploadDraws(const DrawSnapshot& draws)
+{
+	PROFILE_FUNCTION();
+
+	gpuSubmit      = draws.gpuCulling;
+	validateSubmit = draws.validateCommands;
+	commandStats   = {};
+	commandStats.valid = true;
+	if (gpuSubmit)
+	{
+		GpuZone zone("GPU culling");
+		if (draws.rebuildGpuScene) GpuCuller::Build(draws.objects);
+		else                       GpuCuller::UpdateTransforms(draws.moved);
+
+		// Visibility stays on the GPU, only the submission is counted.
+		unsigned int runCount = (unsigned int)GpuCuller::runs.size();
+		stats = { GpuCuller::objectCount, GpuCuller::groupCount, runCount, runCount + 3, 0, 0 };
+
+		GpuCuller::Cull(draws.hiZCulling);
+		return;
+	}
+
+	batches = draws.batches;
+	if (batches.empty())
+	{
+		stats = { 0, 0, 0, 0, 0, 0 };
+		return;
+	}
+
+	ReserveInstances((unsigned int)draws.instances.size());
+
+	// Transforms ordered by batch, in the frame ring.
+	instanceData = FrameRing::AllocateStorage(sizeof(InstanceData) * draws.instances.size());
+	memcpy(instanceData.data, draws.instances.data(), sizeof(InstanceData) * draws.instances.size());
+
+	// One indirect command per batch, the base instance offsets the instances indices.
+	commandData = FrameRing::Allocate(sizeof(DrawCommand) * batches.size(), sizeof(GLuint));
+	DrawCommand* commands = (DrawCommand*)commandData.data;
+	for (size_t i = 0; i < batches.size(); i++)
+	{
+		const Resources::GeometryRange& range = batches[i].mesh->range;
+		commands[i] = { range.indexCount, batches[i].count, range.firstIndex, (GLint)range.baseVertex, batches[i].first };
+	}
+}
+
+void ModelManager::SubmitDraws(const GLuint& sampler, const GLuint& passProgram)
+{
+	PROFILE_FUNCTION();
+
+	if (gpuSubmit)
+	{
+		GpuCuller::Draw(passProgram != 0 ? passProgram : program, sampler);
+		return;
+	}
+	if (batches.empty()) return;
+
+	ExecuteBatches(sampler, passProgram);
+}
+
+// Depth only draws need neither textures nor state sorting: all batches go in a single multi-draw.
+void ModelManager::SubmitDepth(const GLuint& depthProgram)
+{
+	PROFILE_FUNCTION();
+
+	if (gpuSubmit)
+	{
+		GpuCuller::DrawDepth(depthProgram);
+		return;
+	}
+	if (batches.empty()) return;
+
+	commands.Reset();
+	RecordSetup(commands, Resources::GeometryPool::depthVAO);
+	commands.BindProgram(depthProgram);
+	commands.DrawIndirect(commandData.offset, (GLsizei)batches.size());
+	ReplayCommands(1);
 }
 
 Model* ModelManager::GetModel(const char* name)
@@ -27,6 +206,183 @@ Model* ModelManager::GetModel(const char* name)
 
 void ModelManager::Unload()
 {
+	Core::JobSystem::Wait(occlusionJob);
+	occlusionStarted = false;
+
 	for (auto& it : models) delete it.second;
 	models.clear();
+	drawList.clear();
+	gpuSceneDirty = true;
+
+	glDeleteBuffers(1, &instanceIdBuffer);
+	instanceIdBuffer = instanceCapacity = 0;
+}
+
+// ===================================================================
+// ModelManager private methods.
+// ===================================================================
+
+// Walk the scene hierarchy against the camera frustum.
+void ModelManager::Cull(const Camera& camera)
+{
+	visibleNodes.clear();
+	cullingStats = SceneGraph::bvh.Cull(Frustum::FromMatrix(camera.GetVPMat()), visibleNodes);
+
+	// Remove frustum visible models hidden behind occluders.
+	occlusionStats = { 0, 0, 0, 0 };
+	if (occlusionStarted)
+	{
+		Core::JobSystem::Wait(occlusionJob);
+		occlusionStarted = false;
+		occlusionStats = occlusion.Filter(visibleNodes);
+	}
+}
+
+// Push visible models in the render queue and sort it by state, then front to back.
+void ModelManager::BuildQueue(const Camera& camera)
+{
+	Core::Maths::Vector3 cameraPos = camera.GetPosition();
+	float invFar = 1.f / camera.GetFarDistance();
+
+	queue.Resize(visibleNodes.size());
+	drawList.resize(visibleNodes.size());
+
+	// Only models are tracked by the hierarchy, sort keys are built by ranges of visible models.
+	Core::JobSystem::ParallelFor(visibleNodes.size(), JOB_GRAIN, [&](const size_t& first, const size_t& last)
+	{
+		for (size_t i = first; i < last; i++)
+		{
+			Model* model = (Model*)visibleNodes[i];
+			Resources::Mesh* mesh = model->GetMesh();
+			float depth = model->GetData()->worldBounds.center.GetDistanceFromPoint(cameraPos) * invFar;
+
+			queue.Set(i, RenderQueue::MakeKey(RenderPass::Opaque, program, mesh->texture->GetTexture(), mesh->range.index, depth), (uint32_t)i);
+			drawList[i] = model;
+		}
+	});
+
+	queue.Sort();
+}
+
+// Split the sorted queue in runs of identical states and lay their transforms out in order.
+void ModelManager::BuildBatches(DrawSnapshot& output)
+{
+	const vector<RenderItem>& items = queue.GetItems();
+
+	output.instances.resize(items.size());
+
+	for (size_t i = 0; i < items.size(); i++)
+	{
+		// Key fields are truncated GL names: states colliding in the key still split batches.
+		Resources::Mesh* mesh = drawList[items[i].payload]->GetMesh();
+		GLuint texture = mesh->texture->GetTexture();
+		if (i == 0 || RenderQueue::GetStateKey(items[i].key) != RenderQueue::GetStateKey(items[i - 1].key)
+			|| output.batches.back().mesh != mesh || output.batches.back().texture != texture)
+			output.batches.push_back({ mesh, program, texture, (unsigned int)i, 0 });
+
+		output.batches.back().count++;
+	}
+
+	// Transforms are gathered in sorted order by ranges of items.
+	Core::JobSystem::ParallelFor(items.size(), JOB_GRAIN, [&](const size_t& first, const size_t& last)
+	{
+		for (size_t i = first; i < last; i++)
+			memcpy(output.instances[i].model, &drawList[items[i].payload]->GetData()->mat.m[0][0], sizeof(InstanceData));
+	});
+}
+
+// Draw batches with one multi-draw per program / texture run, recorded in parallel in chunks of batches
+// then merged in order and replayed.
+void ModelManager::ExecuteBatches(const GLuint& sampler, const GLuint& passProgram)
+{
+	unsigned int chunkCount = (unsigned int)((batches.size() + COMMAND_RECORD_CHUNK - 1) / COMMAND_RECORD_CHUNK);
+	if (recorders.size() < chunkCount) recorders.resize(chunkCount);
+
+	// Chunks record independently: each one starts without any bound program or texture.
+	Core::JobSystem::ParallelFor(chunkCount, 1, [passProgram](const size_t& first, const size_t& last)
+	{
+		for (size_t i = first; i < last; i++) RecordBatches(recorders[i], i * COMMAND_RECORD_CHUNK, passProgram);
+	});
+
+	// All meshes live in the geometry pool, instances read the sorted transforms in order.
+	commands.Reset();
+	RecordSetup(commands, Resources::GeometryPool::VAO);
+	commands.BindSampler(1, sampler);
+	for (unsigned int i = 0; i < chunkCount; i++) commands.Append(recorders[i]);
+
+	CommandStats before = commandStats;
+	ReplayCommands(chunkCount);
+
+	// Counted from the packets replayed by this pass, plus vertex array, instance buffer and sampler.
+	auto replayed = [&before](const CommandType& type) { return commandStats.counts[(size_t)type] - before.counts[(size_t)type]; };
+	stats = { (unsigned int)(instanceData.size / sizeof(InstanceData)), (unsigned int)batches.size(), replayed(CommandType::DrawIndirect), 0, 0, 0 };
+	stats.binds = 3 + replayed(CommandType::BindProgram) + replayed(CommandType::BindTexture);
+	for (const InstanceBatch& batch : batches) stats.triangles += batch.mesh->range.indexCount / 3 * batch.count;
+
+	// Drawing models one by one binds program, texture, sampler and vertex array for each of them.
+	unsigned int naiveBinds = stats.items * 4;
+	stats.bindsAvoided = naiveBinds > stats.binds ? naiveBinds - stats.binds : 0;
+}
+
+// Record the runs of a chunk of batches, skipping states already bound within the chunk.
+void ModelManager::RecordBatches(CommandBuffer& output, const size_t& firstBatch, const GLuint& passProgram)
+{
+	output.Reset();
+
+	size_t end = min(batches.size(), firstBatch + COMMAND_RECORD_CHUNK);
+	GLuint boundProgram = 0, boundTexture = 0;
+	for (size_t first = firstBatch, last = firstBatch; first < end; first = last)
+	{
+		while (last < end && batches[last].program == batches[first].program && batches[last].texture == batches[first].texture) last++;
+
+		GLuint batchProgram = passProgram != 0 ? passProgram : batches[first].program;
+		if (batchProgram != boundProgram)
+		{
+			output.BindProgram(batchProgram);
+			boundProgram = batchProgram;
+		}
+
+		if (batches[first].texture != boundTexture)
+		{
+			output.BindTexture(1, batches[first].texture);
+			boundTexture = batches[first].texture;
+		}
+
+		output.DrawIndirect(commandData.offset + sizeof(DrawCommand) * first, (GLsizei)(last - first));
+	}
+}
+
+// Buffers shared by every draw of the frame.
+void ModelManager::RecordSetup(CommandBuffer& output, const GLuint& vertexArray)
+{
+	output.BindBufferRange(GL_SHADER_STORAGE_BUFFER, INSTANCES_BINDING, instanceData.buffer, instanceData.offset, instanceData.size);
+	output.BindIndirectBuffer(commandData.buffer);
+	output.BindVertexArray(vertexArray);
+	output.BindVertexBuffer(vertexArray, INSTANCE_BUFFER_INDEX, instanceIdBuffer, 0, sizeof(uint32_t));
+}
+
+// Replay the merged commands, unless the validation failed.
+void ModelManager::ReplayCommands(const unsigned int& recordedBuffers)
+{
+	commandStats.buffers += recordedBuffers;
+	commandStats.valid    = !validateSubmit || commands.Validate();
+	if (commandStats.valid) commands.Execute(commandStats);
+}
+
+// Grow the instances indices buffer to hold at least the given instances count.
+void ModelManager::ReserveInstances(const unsigned int& count)
+{
+	if (count <= instanceCapacity) return;
+
+	instanceCapacity = 64;
+	while (instanceCapacity < count) instanceCapacity *= 2;
+
+	glDeleteBuffers(1, &instanceIdBuffer);
+
+	// Instance i reads transform i, offset by the draw base instance.
+	vector<uint32_t> indices(instanceCapacity);
+	for (unsigned int i = 0; i < instanceCapacity; i++) indices[i] = i;
+
+	glCreateBuffers(1, &instanceIdBuffer);
+	glNamedBufferStorage(instanceIdBuffer, sizeof(uint32_t) * instanceCapacity, indices.data(), 0);
 }
\ No newline at end of file
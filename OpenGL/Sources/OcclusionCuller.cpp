@@ -0,0 +1,316 @@
+#include <cmath>
+#include <cfloat>
+#include <chrono>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+#include <immintrin.h>
+
+#include <Vector3.h>
+#include <Matrix.h>
+#include <Bounds.h>
+#include <SceneNode.h>
+#include <JobSystem.h>
+#include <OcclusionCuller.h>
+
+using namespace std;
+using namespace Core::Maths;
+using namespace Core::Scene;
+using namespace Renderer;
+
+#define OCCLUSION_TILES_X      (OCCLUSION_WIDTH  / OCCLUSION_TILE_SIZE)
+#define OCCLUSION_TILES_Y      (OCCLUSION_HEIGHT / OCCLUSION_TILE_SIZE)
+#define OCCLUSION_TEST_BATCH   256 // Bounds tested per job.
+
+// ===================================================================
+// Occlusion helpers.
+// ===================================================================
+
+// Row vector product of two 4x4 matrices stored row by row.
+static void Multiply(const float* a, const float* b, float* out)
+{
+	for (int i = 0; i < 4; i++)
+		for (int j = 0; j < 4; j++)
+			out[i * 4 + j] = a[i * 4] * b[j] + a[i * 4 + 1] * b[4 + j] + a[i * 4 + 2] * b[8 + j] + a[i * 4 + 3] * b[12 + j];
+}
+
+// Clip space point without z, occlusion depth only needs w.
+struct ClipVertex { float x, y, w; };
+
+static ClipVertex TransformPoint(const Vector3& p, const float* m)
+{
+	return { p.x * m[0] + p.y * m[4] + p.z * m[8]  + m[12],
+			 p.x * m[1] + p.y * m[5] + p.z * m[9]  + m[13],
+			 p.x * m[3] + p.y * m[7] + p.z * m[11] + m[15] };
+}
+
+// ===================================================================
+// OcclusionCuller public methods.
+// ===================================================================
+
+void OcclusionCuller::Begin(const Matrix4& viewProj, const float& nearDistance)
+{
+	memcpy(m_viewProj, &viewProj.m[0][0], sizeof(m_viewProj));
+	m_near = nearDistance;
+	m_occluders.clear();
+}
+
+void OcclusionCuller::AddOccluder(const vector<Vector3>& positions, const vector<uint32_t>& indices, const Matrix4& model)
+{
+	Occluder occluder = { &positions, &indices, {} };
+	memcpy(occluder.model, &model.m[0][0], sizeof(occluder.model));
+	m_occluders.push_back(occluder);
+}
+
+void OcclusionCuller::Rasterize()
+{
+	auto start = chrono::high_resolution_clock::now();
+
+	if (m_levels.empty())
+	{
+		for (int w = OCCLUSION_WIDTH, h = OCCLUSION_HEIGHT; ; w = max(1, w / 2), h = max(1, h / 2))
+		{
+			m_levels.push_back(vector<float>(w * h));
+			if (w == 1 && h == 1) break;
+		}
+		m_bins.resize(OCCLUSION_TILES_X * OCCLUSION_TILES_Y);
+	}
+
+	TransformOccluders();
+	Core::JobSystem::ParallelFor(OCCLUSION_TILES_X * OCCLUSION_TILES_Y, 1, [this](const size_t& first, const size_t& last)
+	{
+		for (size_t tile = first; tile < last; tile++) RasterizeTile((unsigned int)tile);
+	});
+	BuildPyramid();
+
+	m_rasterMs = chrono::duration<float, milli>(chrono::high_resolution_clock::now() - start).count();
+}
+
+OcclusionStats OcclusionCuller::Filter(vector<void*>& nodes) const
+{
+	OcclusionStats stats = { (unsigned int)m_triangles.size(), (unsigned int)nodes.size(), 0, m_rasterMs };
+	if (m_triangles.empty()) return stats;
+
+	static vector<uint8_t> visible;
+	visible.resize(nodes.size());
+
+	Core::JobSystem::ParallelFor(nodes.size(), OCCLUSION_TEST_BATCH, [&](const size_t& first, const size_t& last)
+	{
+		for (size_t i = first; i < last; i++)
+			visible[i] = IsVisible(((SceneNode*)nodes[i])->GetData()->worldBounds);
+	});
+
+	size_t count = 0;
+	for (size_t i = 0; i < nodes.size(); i++)
+		if (visible[i]) nodes[count++] = nodes[i];
+
+	stats.occluded = (unsigned int)(nodes.size() - count);
+	nodes.resize(count);
+	return stats;
+}
+
+// Occluded when the nearest point of the box is behind the farthest occluder depth of the covered area.
+bool OcclusionCuller::IsVisible(const Bounds& bounds) const
+{
+	if (m_levels.empty()) return true;
+
+	float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX, nearest = 0;
+	for (int i = 0; i < 8; i++)
+	{
+		Vector3 corner(bounds.center.x + (i & 1 ? bounds.extents.x : -bounds.extents.x),
+					   bounds.center.y + (i & 2 ? bounds.extents.y : -bounds.extents.y),
+					   bounds.center.z + (i & 4 ? bounds.extents.z : -bounds.extents.z));
+
+		// Boxes crossing the near plane are always visible.
+		ClipVertex clip = TransformPoint(corner, m_viewProj);
+		if (clip.w < m_near) return true;
+
+		float invW = 1 / clip.w;
+		float x = (clip.x * invW * 0.5f + 0.5f) * OCCLUSION_WIDTH;
+		float y = (clip.y * invW * 0.5f + 0.5f) * OCCLUSION_HEIGHT;
+		minX = min(minX, x); maxX = max(maxX, x);
+		minY = min(minY, y); maxY = max(maxY, y);
+		nearest = max(nearest, invW);
+	}
+
+	int x0 = max(0, (int)minX), x1 = min(OCCLUSION_WIDTH  - 1, (int)maxX);
+	int y0 = max(0, (int)minY), y1 = min(OCCLUSION_HEIGHT - 1, (int)maxY);
+	if (x0 > x1 || y0 > y1) return true;
+
+	// Pick the level where the rectangle covers at most 2x2 texels.
+	int size = max(x1 - x0, y1 - y0) + 1, level = 0;
+	while ((1 << level) < size && level < (int)m_levels.size() - 1) level++;
+
+	const vector<float>& depth = m_levels[level];
+	int width = max(1, OCCLUSION_WIDTH >> level);
+
+	float farthest = FLT_MAX;
+	for (int y = y0 >> level; y <= y1 >> level; y++)
+		for (int x = x0 >> level; x <= x1 >> level; x++)
+			farthest = min(farthest, depth[y * width + x]);
+
+	return nearest >= farthest;
+}
+
+const vector<float>& OcclusionCuller::GetDepth() const { return m_levels[0]; }
+
+// ===================================================================
+// OcclusionCuller private methods.
+// ===================================================================
+
+// Clip occluders triangles against the near plane, project them and bin them into tiles.
+void OcclusionCuller::TransformOccluders()
+{
+	m_triangles.clear();
+	for (vector<uint32_t>& bin : m_bins) bin.clear();
+
+	for (const Occluder& occluder : m_occluders)
+	{
+		float mvp[16];
+		Multiply(occluder.model, m_viewProj, mvp);
+
+		const vector<Vector3>&  positions = *occluder.positions;
+		const vector<uint32_t>& indices   = *occluder.indices;
+		for (size_t i = 0; i + 2 < indices.size(); i += 3)
+		{
+			ClipVertex in[3] = { TransformPoint(positions[indices[i]], mvp), TransformPoint(positions[indices[i + 1]], mvp), TransformPoint(positions[indices[i + 2]], mvp) };
+
+			// Near plane clipping, a triangle becomes a polygon of up to 4 vertices.
+			ClipVertex polygon[4];
+			int count = 0;
+			for (int v = 0; v < 3; v++)
+			{
+				const ClipVertex& a = in[v];
+				const ClipVertex& b = in[(v + 1) % 3];
+
+				if (a.w >= m_near) polygon[count++] = a;
+				if ((a.w >= m_near) != (b.w >= m_near))
+				{
+					float t = (m_near - a.w) / (b.w - a.w);
+					polygon[count++] = { a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, m_near };
+				}
+			}
+
+			for (int v = 1; v + 1 < count; v++)
+			{
+				ScreenTriangle triangle;
+				const ClipVertex* fan[3] = { &polygon[0], &polygon[v], &polygon[v + 1] };
+				for (int j = 0; j < 3; j++)
+				{
+					triangle.invW[j] = 1 / fan[j]->w;
+					triangle.x[j] = (fan[j]->x * triangle.invW[j] * 0.5f + 0.5f) * OCCLUSION_WIDTH;
+					triangle.y[j] = (fan[j]->y * triangle.invW[j] * 0.5f + 0.5f) * OCCLUSION_HEIGHT;
+				}
+
+				// Counter clockwise winding, degenerate triangles are skipped.
+				float area = (triangle.x[1] - triangle.x[0]) * (triangle.y[2] - triangle.y[0]) - (triangle.x[2] - triangle.x[0]) * (triangle.y[1] - triangle.y[0]);
+				if (area == 0) continue;
+				if (area < 0)
+				{
+					swap(triangle.x[1], triangle.x[2]);
+					swap(triangle.y[1], triangle.y[2]);
+					swap(triangle.invW[1], triangle.invW[2]);
+				}
+
+				// Tiles overlapped by the triangle bounding rectangle.
+				float minX = min(triangle.x[0], min(triangle.x[1], triangle.x[2])), maxX = max(triangle.x[0], max(triangle.x[1], triangle.x[2]));
+				float minY = min(triangle.y[0], min(triangle.y[1], triangle.y[2])), maxY = max(triangle.y[0], max(triangle.y[1], triangle.y[2]));
+				if (maxX < 0 || maxY < 0 || minX >= OCCLUSION_WIDTH || minY >= OCCLUSION_HEIGHT) continue;
+
+				int tileX0 = max(0, (int)minX / OCCLUSION_TILE_SIZE), tileX1 = min(OCCLUSION_TILES_X - 1, (int)maxX / OCCLUSION_TILE_SIZE);
+				int tileY0 = max(0, (int)minY / OCCLUSION_TILE_SIZE), tileY1 = min(OCCLUSION_TILES_Y - 1, (int)maxY / OCCLUSION_TILE_SIZE);
+
+				uint32_t index = (uint32_t)m_triangles.size();
+				m_triangles.push_back(triangle);
+				for (int ty = tileY0; ty <= tileY1; ty++)
+					for (int tx = tileX0; tx <= tileX1; tx++)
+						m_bins[ty * OCCLUSION_TILES_X + tx].push_back(index);
+			}
+		}
+	}
+}
+
+// Clear a tile and rasterize its triangles four pixels at a time, keeping the nearest depth.
+void OcclusionCuller::RasterizeTile(const unsigned int& tile)
+{
+	vector<float>& depth = m_levels[0];
+	int tileX = (tile % OCCLUSION_TILES_X) * OCCLUSION_TILE_SIZE;
+	int tileY = (tile / OCCLUSION_TILES_X) * OCCLUSION_TILE_SIZE;
+
+	for (int y = tileY; y < tileY + OCCLUSION_TILE_SIZE; y++)
+		memset(&depth[y * OCCLUSION_WIDTH + tileX], 0, sizeof(float) * OCCLUSION_TILE_SIZE);
+
+	const __m128 pixelOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+	const __m128 zero = _mm_setzero_ps();
+
+	for (const uint32_t& index : m_bins[tile])
+	{
+		const ScreenTriangle& t = m_triangles[index];
+
+		// Edge functions E(p) = A * x + B * y + C, positive inside.
+		float A[3], B[3], C[3];
+		for (int e = 0; e < 3; e++)
+		{
+			int i = e, j = (e + 1) % 3;
+			A[e] = t.y[i] - t.y[j];
+			B[e] = t.x[j] - t.x[i];
+			C[e] = -A[e] * t.x[i] - B[e] * t.y[i];
+		}
+
+		// Depth plane from the edges opposite to vertices 1 and 2.
+		float area = C[0] + C[1] + C[2];
+		float d1 = (t.invW[1] - t.invW[0]) / area, d2 = (t.invW[2] - t.invW[0]) / area;
+		float zA = A[2] * d1 + A[0] * d2, zB = B[2] * d1 + B[0] * d2, zC = t.invW[0] + C[2] * d1 + C[0] * d2;
+
+		int minX = max(tileX, (int)min(t.x[0], min(t.x[1], t.x[2])));
+		int maxX = min(tileX + OCCLUSION_TILE_SIZE - 1, (int)max(t.x[0], max(t.x[1], t.x[2])));
+		int minY = max(tileY, (int)min(t.y[0], min(t.y[1], t.y[2])));
+		int maxY = min(tileY + OCCLUSION_TILE_SIZE - 1, (int)max(t.y[0], max(t.y[1], t.y[2])));
+
+		for (int y = minY; y <= maxY; y++)
+		{
+			float py = y + 0.5f;
+			__m128 rowE0 = _mm_set1_ps(B[0] * py + C[0]), rowE1 = _mm_set1_ps(B[1] * py + C[1]), rowE2 = _mm_set1_ps(B[2] * py + C[2]);
+			__m128 rowZ  = _mm_set1_ps(zB * py + zC);
+
+			for (int x = minX & ~3; x <= maxX; x += 4)
+			{
+				__m128 px = _mm_add_ps(_mm_set1_ps((float)x), pixelOffsets);
+				__m128 e0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(A[0]), px), rowE0);
+				__m128 e1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(A[1]), px), rowE1);
+				__m128 e2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(A[2]), px), rowE2);
+
+				__m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+				if (_mm_movemask_ps(inside) == 0) continue;
+
+				float* dst = &depth[y * OCCLUSION_WIDTH + x];
+				__m128 z   = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(zA), px), rowZ);
+				__m128 old = _mm_loadu_ps(dst);
+				_mm_storeu_ps(dst, _mm_or_ps(_mm_and_ps(inside, _mm_max_ps(old, z)), _mm_andnot_ps(inside, old)));
+			}
+		}
+	}
+}
+
+// Each texel keeps the farthest (smallest 1/w) depth of the texels it covers.
+void OcclusionCuller::BuildPyramid()
+{
+	for (size_t level = 1; level < m_levels.size(); level++)
+	{
+		int srcWidth  = max(1, OCCLUSION_WIDTH  >> (level - 1)), srcHeight = max(1, OCCLUSION_HEIGHT >> (level - 1));
+		int width     = max(1, OCCLUSION_WIDTH  >> level),       height    = max(1, OCCLUSION_HEIGHT >> level);
+		const vector<float>& src = m_levels[level - 1];
+		vector<float>& dst = m_levels[level];
+
+		for (int y = 0; y < height; y++)
+		{
+			int y0 = min(y * 2, srcHeight - 1), y1 = min(y * 2 + 1, srcHeight - 1);
+			for (int x = 0; x < width; x++)
+			{
+				int x0 = min(x * 2, srcWidth - 1), x1 = min(x * 2 + 1, srcWidth - 1);
+				dst[y * width + x] = min(min(src[y0 * srcWidth + x0], src[y0 * srcWidth + x1]), min(src[y1 * srcWidth + x0], src[y1 * srcWidth + x1]));
+			}
+		}
+	}
+}
\ No newline at end of file
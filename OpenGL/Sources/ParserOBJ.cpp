@@ -3,11 +3,15 @@
 #include <string>
 #include <vector>
 #include <chrono>
+#include <cfloat>
+#include <algorithm>
 
 #include <Debug.h>
+#include <CpuProfiler.h>
 #include <Vector2.h>
 #include <Vector3.h>
 #include <Vertex.h>
+#include <Bounds.h>
 #include <Mesh.h>
 #include <ParserOBJ.h>
 
@@ -21,6 +25,8 @@ using namespace Resources;
  
 Resources::MeshData ParserOBJ::ParseInputFile(const char* path)
 {
+	PROFILE_FUNCTION();
+
 	//! Chrono debug start.
 	chrono::steady_clock::time_point chronoStart = std::chrono::high_resolution_clock::now();
 
@@ -91,7 +97,7 @@ Resources::MeshData ParserOBJ::ParseInputFile(const char* path)
     Log(Debug::LogType::INFO, string("Loading model ") + path + string(" took ") + to_string(elapsed.count() * 1e-9) + " seconds.");
 
 	// Return model data.
-	return {m_verticesNumber, vertices, nIndices};
+	return {m_verticesNumber, vertices, nIndices, ComputeBounds(vertices)};
 }
 
 // ===================================================================
@@ -136,4 +142,27 @@ vector<IndexOBJ> ParserOBJ::ParseIndices(const char* cursor)
 	}
 
 	return indices;
+}
+
+Maths::Bounds ParserOBJ::ComputeBounds(const vector<Maths::Vertex>& vertices)
+{
+	Maths::Bounds bounds;
+	if (vertices.empty()) return bounds;
+
+	// Axis-aligned box.
+	Maths::Vector3 min( FLT_MAX,  FLT_MAX,  FLT_MAX);
+	Maths::Vector3 max(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+	for (const Maths::Vertex& vertex : vertices)
+	{
+		min = Maths::Vector3(std::min(min.x, vertex.pos.x), std::min(min.y, vertex.pos.y), std::min(min.z, vertex.pos.z));
+		max = Maths::Vector3(std::max(max.x, vertex.pos.x), std::max(max.y, vertex.pos.y), std::max(max.z, vertex.pos.z));
+	}
+	bounds.center  = Maths::Vector3((min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f, (min.z + max.z) * 0.5f);
+	bounds.extents = Maths::Vector3((max.x - min.x) * 0.5f, (max.y - min.y) * 0.5f, (max.z - min.z) * 0.5f);
+
+	// Sphere around the box center, tighter than the box diagonal.
+	for (const Maths::Vertex& vertex : vertices)
+		bounds.radius = std::max(bounds.radius, vertex.pos.GetDistanceFromPoint(bounds.center));
+
+	return bounds;
 }
\ No newline at end of file
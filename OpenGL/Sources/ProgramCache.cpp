@@ -0,0 +1,110 @@
+#include <glad/glad.h>
+#include <MeowHash/meow_hash_x64_aesni.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include <Debug.h>
+#include <ProgramCache.h>
+
+using namespace std;
+using namespace Core::Debug;
+using namespace Resources;
+
+// Program cache static declaration.
+string ProgramCache::directory = "Assets/Cache/";
+
+// ===================================================================
+// ProgramCache public methods.
+// ===================================================================
+
+uint64_t ProgramCache::GetKey(const vector<string>& sources)
+{
+	// A binary is only valid for the driver that produced it.
+	string key = string((const char*)glGetString(GL_RENDERER)) + "\n" + (const char*)glGetString(GL_VERSION) + "\n";
+	for (const string& source : sources) key += source + "\n";
+
+	meow_u128 hash = MeowHash(MeowDefaultSeed, key.size(), (void*)key.data());
+	return MeowU64From(hash, 0);
+}
+
+bool ProgramCache::Load(const GLuint& program, const uint64_t& key)
+{
+	// Program binaries are only usable if the driver exposes at least one format.
+	GLint formatsCount = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatsCount);
+	if (formatsCount <= 0) return false;
+
+	ifstream file(GetPath(key), ios::binary);
+	if (!file.is_open()) return false;
+
+	// Check the header before reading the binary blob.
+	ProgramCacheHeader header;
+	file.read((char*)&header, sizeof(ProgramCacheHeader));
+	if (!file || header.magic != PROGRAM_CACHE_MAGIC || header.key != key || header.length <= 0)
+	{
+		Log(LogType::WARNING, "Invalid program cache file, recompiling shaders.");
+		return false;
+	}
+
+	// The binary format must still be supported by the current driver.
+	vector<GLint> formats(formatsCount);
+	glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, formats.data());
+	if (find(formats.begin(), formats.end(), (GLint)header.format) == formats.end()) return false;
+
+	vector<char> binary(header.length);
+	file.read(binary.data(), header.length);
+	if (!file) return false;
+	file.close();
+
+	glProgramBinary(program, header.format, binary.data(), header.length);
+
+	// Drivers reject binaries on any mismatch, in which case the caller compiles from sources.
+	GLint success = 0;
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+	return success;
+}
+
+void ProgramCache::Save(const GLuint& program, const uint64_t& key)
+{
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0) return;
+
+	// Retrieve the linked program binary.
+	ProgramCacheHeader header = { PROGRAM_CACHE_MAGIC, key, 0, 0 };
+	vector<char> binary(length);
+	glGetProgramBinary(program, length, &header.length, &header.format, binary.data());
+	if (header.length <= 0) return;
+
+	// Write it next to the other cached programs.
+	error_code error;
+	filesystem::create_directories(directory, error);
+
+	ofstream file(GetPath(key), ios::binary | ios::trunc);
+	if (!file.is_open())
+	{
+		Log(LogType::WARNING, string("Can't write program cache file ") + GetPath(key) + ".");
+		return;
+	}
+
+	file.write((const char*)&header, sizeof(ProgramCacheHeader));
+	file.write(binary.data(), header.length);
+	file.close();
+}
+
+// ===================================================================
+// ProgramCache private methods.
+// ===================================================================
+
+string ProgramCache::GetPath(const uint64_t& key)
+{
+	ostringstream path;
+	path << directory << hex << setw(16) << setfill('0') << key << ".bin";
+	return path.str();
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <RenderQueue.h>
+
+using namespace std;
+using namespace Renderer;
+
+// ===================================================================
+// RenderQueue static methods.
+// ===================================================================
+
+uint64_t RenderQueue::MakeKey(const RenderPass& pass, const unsigned int& program, const unsigned int& texture, const unsigned int& mesh, const float& depth)
+{
+	const uint64_t depthMax = (1ull << SORT_KEY_DEPTH_BITS) - 1;
+	uint64_t quantizedDepth = (uint64_t)(min(max(depth, 0.f), 1.f) * depthMax);
+
+	uint64_t key = (uint64_t)pass & ((1ull << SORT_KEY_PASS_BITS) - 1);
+	key = (key << SORT_KEY_PROGRAM_BITS) | (program & ((1ull << SORT_KEY_PROGRAM_BITS) - 1));
+	key = (key << SORT_KEY_TEXTURE_BITS) | (texture & ((1ull << SORT_KEY_TEXTURE_BITS) - 1));
+	key = (key << SORT_KEY_MESH_BITS)    | (mesh    & ((1ull << SORT_KEY_MESH_BITS)    - 1));
+	key = (key << SORT_KEY_DEPTH_BITS)   | quantizedDepth;
+	return key;
+}
+
+uint64_t RenderQueue::GetStateKey(const uint64_t& key)
+{
+	return key >> SORT_KEY_DEPTH_BITS;
+}
+
+// ===================================================================
+// RenderQueue public methods.
+// ===================================================================
+
+void RenderQueue::Clear()
+{
+	m_items.clear();
+}
+
+void RenderQueue::Push(const uint64_t& key, const uint32_t& payload)
+{
+	m_items.push_back({ key, payload });
+}
+
+void RenderQueue::Resize(const size_t& count)
+{
+	m_items.resize(count);
+}
+
+void RenderQueue::Set(const size_t& index, const uint64_t& key, const uint32_t& payload)
+{
+	m_items[index] = { key, payload };
+}
+
+void RenderQueue::Sort()
+{
+	size_t count = m_items.size();
+	if (count < 2) return;
+
+	m_scratch.resize(count);
+	RenderItem* src = m_items.data();
+	RenderItem* dst = m_scratch.data();
+
+	// One counting sort pass per key byte, from least to most significant.
+	for (int shift = 0; shift < 64; shift += 8)
+	{
+		size_t histogram[256] = {};
+		for (size_t i = 0; i < count; i++) histogram[(src[i].key >> shift) & 0xFF]++;
+
+		// Skip bytes shared by all items (unused key bits, single program...).
+		if (histogram[(src[0].key >> shift) & 0xFF] == count) continue;
+
+		size_t offset = 0;
+		for (int i = 0; i < 256; i++)
+		{
+			size_t bucketCount = histogram[i];
+			histogram[i] = offset;
+			offset += bucketCount;
+		}
+
+		for (size_t i = 0; i < count; i++) dst[histogram[(src[i].key >> shift) & 0xFF]++] = src[i];
+		swap(src, dst);
+	}
+
+	// The sorted items may have ended in the scratch buffer.
+	if (src != m_items.data()) m_items.swap(m_scratch);
+}
+
+const vector<RenderItem>& RenderQueue::GetItems() const { return m_items; }
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include <glad/glad.h>
+
+#include <cmath>
+#include <algorithm>
+
+#include <GpuProfiler.h>
+#include <ResolutionScaler.h>
+
+using namespace std;
+using namespace Renderer;
+
+// Resolution scaler static declaration.
+ResolutionSettings ResolutionScaler::settings     = { false, 16.6f, 0.5f, 1.f };
+float              ResolutionScaler::scale        = 1;
+int                ResolutionScaler::width        = 0;
+int                ResolutionScaler::height       = 0;
+float              ResolutionScaler::desiredScale = 1;
+float              ResolutionScaler::scales[GPU_PROFILER_LATENCY] = {};
+unsigned int       ResolutionScaler::frame        = 0;
+GLuint             ResolutionScaler::framebuffer  = 0;
+GLuint             ResolutionScaler::color        = 0;
+GLuint             ResolutionScaler::depth        = 0;
+int                ResolutionScaler::targetWidth  = 0;
+int                ResolutionScaler::targetHeight = 0;
+GLint              ResolutionScaler::output       = 0;
+int                ResolutionScaler::outputWidth  = 0;
+int                ResolutionScaler::outputHeight = 0;
+
+// ===================================================================
+// ResolutionScaler public methods.
+// ===================================================================
+
+// The profiler reads back the frame issued GPU_PROFILER_LATENCY frames ago, its times are compared with the scale it used.
+void ResolutionScaler::Update(const ResolutionSettings& _settings)
+{
+	frame++;
+	float& slot = scales[frame % GPU_PROFILER_LATENCY];
+	float measuredScale = slot;
+
+	if (!_settings.enabled)
+	{
+		scale = desiredScale = 1;
+		slot  = 0;
+		return;
+	}
+
+	float frameMs = GpuProfiler::GetMs("Frame");
+	float sceneMs = GpuProfiler::GetMs("Scene");
+	if (measuredScale > 0 && sceneMs > 0 && fabsf(frameMs - _settings.targetMs) > _settings.targetMs * RESOLUTION_DEADBAND)
+	{
+		// Scene time grows with its pixel count, the rest of the frame (interface, upscale) does not scale.
+		float sceneBudget = _settings.targetMs - (frameMs - sceneMs);
+		float fitScale    = sceneBudget > 0 ? measuredScale * sqrtf(sceneBudget / sceneMs) : _settings.minScale;
+		desiredScale += (fitScale - desiredScale) * RESOLUTION_RATE;
+	}
+
+	desiredScale = clamp(desiredScale, _settings.minScale, _settings.maxScale);
+	scale = clamp(roundf(desiredScale / RESOLUTION_SCALE_STEP) * RESOLUTION_SCALE_STEP, _settings.minScale, _settings.maxScale);
+	slot  = scale;
+}
+
+// Bind the scene target, the scene is drawn in its bottom left corner at the scaled size.
+void ResolutionScaler::Begin(const int& _outputWidth, const int& _outputHeight, int& sceneWidth, int& sceneHeight)
+{
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &output);
+	outputWidth  = _outputWidth;
+	outputHeight = _outputHeight;
+
+	Reserve(outputWidth, outputHeight);
+	width  = sceneWidth  = max(1, (int)(outputWidth  * scale));
+	height = sceneHeight = max(1, (int)(outputHeight * scale));
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+}
+
+void ResolutionScaler::End()
+{
+	GpuZone zone("Upscale");
+	glBlitNamedFramebuffer(framebuffer, output, 0, 0, width, height, 0, 0, outputWidth, outputHeight, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+	glBindFramebuffer(GL_FRAMEBUFFER, output);
+	glViewport(0, 0, outputWidth, outputHeight);
+}
+
+void ResolutionScaler::Unload()
+{
+	glDeleteFramebuffers (1, &framebuffer);
+	glDeleteRenderbuffers(1, &color);
+	glDeleteRenderbuffers(1, &depth);
+	framebuffer = color = depth = 0;
+	targetWidth = targetHeight  = 0;
+}
+
+// ===================================================================
+// ResolutionScaler private methods.
+// ===================================================================
+
+// Allocated at the full output size, scale changes only move the viewport.
+void ResolutionScaler::Reserve(const int& _width, const int& _height)
+{
+	if (_width == targetWidth && _height == targetHeight && framebuffer != 0) return;
+
+	Unload();
+	targetWidth  = _width;
+	targetHeight = _height;
+
+	// Same depth format as the Hi-Z source, which is blitted from the bound framebuffer.
+	glCreateRenderbuffers(1, &color);
+	glNamedRenderbufferStorage(color, GL_RGBA8, targetWidth, targetHeight);
+	glCreateRenderbuffers(1, &depth);
+	glNamedRenderbufferStorage(depth, GL_DEPTH24_STENCIL8, targetWidth, targetHeight);
+
+	glCreateFramebuffers(1, &framebuffer);
+	glNamedFramebufferRenderbuffer(framebuffer, GL_COLOR_ATTACHMENT0,        GL_RENDERBUFFER, color);
+	glNamedFramebufferRenderbuffer(framebuffer, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth);
+}
\ No newline at end of file
@@ -1,8 +1,13 @@
 #include <glad/glad.h>
 
 #include <string>
+#include <vector>
 
 #include <Texture.h>
+#include <Shader.h>
+#include <ProgramCache.h>
+#include <CpuProfiler.h>
+#include <ShaderReflection.h>
 #include <ResourceManager.h>
 
 using namespace std;
@@ -13,6 +18,67 @@ using namespace Resources;
 // ResourceManager public methods.
 // ===================================================================
 
+GLuint ResourceManager::CreateProgram(const vector<pair<const char*, ShaderType>>& stages, const string& defines)
+{
+	PROFILE_FUNCTION();
+
+	GLuint program = glCreateProgram();
+
+	// Try to load the program binary from the cache first.
+	vector<string> sources;
+	for (auto& it : stages) sources.push_back(Shader::ReadSource(it.first, defines));
+
+	uint64_t key = ProgramCache::GetKey(sources);
+	if (ProgramCache::Load(program, key))
+	{
+		Log(LogType::INFO, "Loaded shader program from cache.");
+		reflections[program].Reflect(program);
+		return program;
+	}
+
+	int success; char infoLog[512];
+
+	// Attach all created shaders to the shader program.
+	for (auto& it : stages)
+		glAttachShader(program, Create<Shader>(it.first, it.second, defines.c_str())->GetShader());
+
+	// Link shaders (the binary must be retrievable to be cached).
+	glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	glLinkProgram(program);
+
+	// Check for linking errors.
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+
+	if (!success)
+	{
+		glGetProgramInfoLog(program, 512, NULL, infoLog);
+		Log(LogType::ERROR, string("ERROR::SHADER::PROGRAM::LINKING_FAILED") + infoLog);
+	}
+	else
+	{
+		ProgramCache::Save(program, key);
+	}
+
+	reflections[program].Reflect(program);
+
+	// Unload compiled shaders from memory and clear shaders list.
+	for (auto& it : shaders) it.second.Unload();
+	shaders.clear();
+
+	return program;
+}
+
+ShaderReflection* ResourceManager::GetReflection(const GLuint& program)
+{
+	if (reflections.find(program) == reflections.end())
+	{
+		Log(LogType::WARNING, string("Could'nt find reflection of program: ") + to_string(program) + ".");
+		return nullptr;
+	}
+
+	return &reflections[program];
+}
+
 void ResourceManager::Unload()
 {
 	for (auto& it : textures) it.second.Unload();
@@ -22,4 +88,7 @@ void ResourceManager::Unload()
 	textures.clear();
 	shaders.clear();
 	meshes.clear();
+
+	for (auto& it : reflections) glDeleteProgram(it.first);
+	reflections.clear();
 }
\ No newline at end of file
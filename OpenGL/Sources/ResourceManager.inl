@@ -37,8 +37,9 @@ inline Shader* ResourceManager::Create(const char* path, ...)
 	va_list args;
     va_start(args, path); 
 
-	ShaderType shaderType = va_arg(args, ShaderType); // Contains the shader type from GL enum.
-	shaders[path] = Shader(path, shaderType);
+	ShaderType  shaderType = va_arg(args, ShaderType);  // Contains the shader type from GL enum.
+	const char* defines    = va_arg(args, const char*); // Contains the defines injected after #version.
+	shaders[path] = Shader(path, shaderType, defines);
 
 	va_end(args);
 	return &shaders[path];
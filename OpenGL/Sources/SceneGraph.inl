@@ -23,7 +23,10 @@ SceneNode* SceneGraph::AddNode(const string& name, SceneNode* node)
 
 SceneNode* SceneGraph::AddNode(const string& name, Model* node)
 {
-	nodes.emplace(name, node);
+	// Models have bounds, track them in the hierarchy.
+	if (nodes.emplace(name, node).second)
+		node->SetProxy(bvh.Insert(node->GetData()->worldBounds, node));
+
 	return GetNode(name);
 }
 
@@ -32,7 +35,25 @@ SceneNode* SceneGraph::GetNode(const string& name)
 	return nodes[name];
 }
 
+// Nodes moved several times in a frame are queued once.
+void SceneGraph::QueueMoved(SceneNode* node)
+{
+	if (node->m_moved) return;
+
+	node->m_moved = true;
+	movedNodes.push_back(node);
+}
+
+void SceneGraph::ClearMoved()
+{
+	for (SceneNode* node : movedNodes) node->m_moved = false;
+	movedNodes.clear();
+}
+
+// Nodes are already deleted, their flags are not reset.
 void SceneGraph::Unload()
 {
+	movedNodes.clear();
 	nodes.clear();
+	bvh.Clear();
 }
\ No newline at end of file
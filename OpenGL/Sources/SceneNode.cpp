@@ -6,6 +6,7 @@
 #include <Model.h>
 #include <Light.h>
 #include <SceneNode.h>
+#include <SceneGraph.h>
 
 using namespace std;
 using namespace Core::Maths;
@@ -19,7 +20,7 @@ using namespace Renderer;
 SceneNode::SceneNode() { }
 
 SceneNode::SceneNode(string name)
-	: m_data({name, Transform(), Matrix4()})
+	: m_data({name, Transform(), Matrix4(), Bounds(), Bounds()})
 {
 	UpdateMat(m_data.transform);
 }
@@ -50,7 +51,29 @@ void SceneNode::SetScale(const Vector3& scale)
 	UpdateMat(m_data.transform);
 }
 
+void SceneNode::SetLocalBounds(const Bounds& bounds)
+{
+	m_data.localBounds = bounds;
+	m_data.worldBounds = bounds.GetTransformed(m_data.mat);
+	if (m_proxy != -1)
+	{
+		SceneGraph::bvh.Move(m_proxy, m_data.worldBounds);
+		SceneGraph::QueueMoved(this);
+	}
+}
+
+void SceneNode::SetProxy(const int& proxy)
+{
+	m_proxy = proxy;
+}
+
 void SceneNode::UpdateMat(const Transform& transform)
 {
 	m_data.mat = GetTransformMatrix(transform.position, transform.rotation, transform.scale, false);
+	m_data.worldBounds = m_data.localBounds.GetTransformed(m_data.mat);
+	if (m_proxy != -1)
+	{
+		SceneGraph::bvh.Move(m_proxy, m_data.worldBounds);
+		SceneGraph::QueueMoved(this);
+	}
 }
\ No newline at end of file
@@ -0,0 +1,212 @@
+#include <glad/glad.h>
+
+#include <Debug.h>
+#include <Vector3.h>
+#include <Uniform.h>
+#include <ResourceManager.h>
+#include <FrameConstants.h>
+#include <LightManager.h>
+#include <ModelManager.h>
+#include <GpuProfiler.h>
+#include <GLState.h>
+#include <SceneRenderer.h>
+#include <FrameQueue.h>
+
+using namespace Core::Debug;
+using namespace Renderer;
+
+// Scene renderer static declaration.
+RenderPath        SceneRenderer::path    = RenderPath::Forward;
+RenderPath        SceneRenderer::renderedPath = RenderPath::Forward;
+RenderPassTimings SceneRenderer::timings = { 0, 0, 0, 0, 0, 0 };
+bool              SceneRenderer::depthPrepass = false;
+bool              SceneRenderer::deferredFailed = false;
+GLuint SceneRenderer::gBufferProgram = 0, SceneRenderer::lightingProgram = 0, SceneRenderer::depthProgram = 0;
+GLuint SceneRenderer::gBuffer        = 0, SceneRenderer::albedoTexture   = 0, SceneRenderer::normalTexture = 0, SceneRenderer::depthTexture = 0;
+GLuint SceneRenderer::litFramebuffer = 0, SceneRenderer::litTexture      = 0;
+int    SceneRenderer::width = 0, SceneRenderer::height = 0;
+
+// ===================================================================
+// SceneRenderer public methods.
+// ===================================================================
+
+void SceneRenderer::Init()
+{
+	gBufferProgram = Resources::ResourceManager::CreateProgram({
+		{ "Assets/Shaders/VertexShader.vert", Resources::ShaderType::VertexShader   },
+		{ "Assets/Shaders/GBuffer.frag",      Resources::ShaderType::FragmentShader }
+	});
+	lightingProgram = Resources::ResourceManager::CreateProgram({ { "Assets/Shaders/TiledLighting.comp", Resources::ShaderType::ComputeShader } });
+	depthProgram    = Resources::ResourceManager::CreateProgram({ { "Assets/Shaders/DepthOnly.vert",     Resources::ShaderType::VertexShader  } });
+
+	Resources::Uniform<int>(gBufferProgram,  "tex").Set(1);
+	Resources::Uniform<int>(lightingProgram, "gAlbedo").Set(GBUFFER_ALBEDO_UNIT);
+	Resources::Uniform<int>(lightingProgram, "gNormal").Set(GBUFFER_NORMAL_UNIT);
+	Resources::Uniform<int>(lightingProgram, "gDepth") .Set(GBUFFER_DEPTH_UNIT);
+}
+
+// Render a scene snapshot in the current framebuffer with the path selected when it was built.
+void SceneRenderer::Render(const SceneSnapshot& snapshot, const GLuint& sampler)
+{
+	renderedPath = snapshot.path == RenderPath::Deferred && !deferredFailed ? RenderPath::Deferred : RenderPath::Forward;
+	if (renderedPath == RenderPath::Deferred) RenderDeferred(snapshot, sampler);
+	else                                      RenderForward (snapshot, sampler);
+}
+
+void SceneRenderer::Unload()
+{
+	DeleteTargets();
+}
+
+// ===================================================================
+// SceneRenderer private methods.
+// ===================================================================
+
+// Lights are assigned to view clusters, then each model shades the lights of its fragments clusters.
+void SceneRenderer::RenderForward(const SceneSnapshot& snapshot, const GLuint& sampler)
+{
+	GpuProfiler::Begin("Light assignment");
+	LightManager::Upload(snapshot.lights, true);
+	GpuProfiler::End();
+
+	if (!snapshot.depthPrepass)
+	{
+		GpuProfiler::Begin("Forward shading");
+		ModelManager::UploadDraws(snapshot.draws);
+		ModelManager::SubmitDraws(sampler);
+		GpuProfiler::End();
+	}
+	else
+	{
+		// Depth only pass of the visible models, without color writes.
+		GpuProfiler::Begin("Depth pre-pass");
+		ModelManager::UploadDraws(snapshot.draws);
+		glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+		ModelManager::SubmitDepth(depthProgram);
+		glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+		GpuProfiler::End();
+
+		// Lit pass of the same draws, only the nearest fragment passes the depth test.
+		GpuProfiler::Begin("Forward shading");
+		glDepthFunc(GL_EQUAL);
+		glDepthMask(GL_FALSE);
+		ModelManager::SubmitDraws(sampler);
+		glDepthMask(GL_TRUE);
+		glDepthFunc(GL_LESS);
+		GpuProfiler::End();
+	}
+
+	// Read back by the profiler a few frames later.
+	timings.lightAssignment = GpuProfiler::GetMs("Light assignment");
+	timings.prepass         = snapshot.depthPrepass ? GpuProfiler::GetMs("Depth pre-pass") : 0;
+	timings.forward         = GpuProfiler::GetMs("Forward shading");
+}
+
+// Models only write their surface to the G-buffer, lights are then culled per screen tile and shaded once per pixel.
+void SceneRenderer::RenderDeferred(const SceneSnapshot& snapshot, const GLuint& sampler)
+{
+	// Uploaded even without targets, the next snapshots only hold their own changes.
+	LightManager::Upload(snapshot.lights, false);
+	ModelManager::UploadDraws(snapshot.draws);
+
+	// Scene resolution, below the framebuffer one with dynamic resolution.
+	ResizeTargets((int)FrameConstants::data.viewport[0], (int)FrameConstants::data.viewport[1]);
+	if (gBuffer == 0) return;
+
+	// Headless runs composite in an offscreen target.
+	GLint target = 0;
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &target);
+
+	// Geometry pass.
+	GpuProfiler::Begin("G-buffer");
+	const float zero[4] = { 0, 0, 0, 0 };
+	glClearNamedFramebufferfv(gBuffer, GL_COLOR, 0, zero);
+	glClearNamedFramebufferfv(gBuffer, GL_COLOR, 1, zero);
+	glClearNamedFramebufferfi(gBuffer, GL_DEPTH_STENCIL, 0, 1.f, 0);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, gBuffer);
+	ModelManager::SubmitDraws(sampler, gBufferProgram);
+	glBindFramebuffer(GL_FRAMEBUFFER, target);
+	GpuProfiler::End();
+
+	// Tiled lighting pass, background pixels take the clear color.
+	GpuProfiler::Begin("Tiled lighting");
+	float clearColor[4];
+	glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+
+	GLState::BindTextureUnit(GBUFFER_ALBEDO_UNIT, albedoTexture);
+	GLState::BindTextureUnit(GBUFFER_NORMAL_UNIT, normalTexture);
+	GLState::BindTextureUnit(GBUFFER_DEPTH_UNIT,  depthTexture);
+	glBindImageTexture(0, litTexture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA8);
+
+	GLState::UseProgram(lightingProgram);
+	Resources::Uniform<Core::Maths::Vector3>(lightingProgram, "background").Set({ clearColor[0], clearColor[1], clearColor[2] });
+	glDispatchCompute((width + LIGHTING_TILE_SIZE - 1) / LIGHTING_TILE_SIZE, (height + LIGHTING_TILE_SIZE - 1) / LIGHTING_TILE_SIZE, 1);
+	glMemoryBarrier(GL_FRAMEBUFFER_BARRIER_BIT);
+	GpuProfiler::End();
+
+	// Composite the lit image over the target framebuffer.
+	GpuProfiler::Begin("Composite");
+	glBlitNamedFramebuffer(litFramebuffer, target, 0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+	GpuProfiler::End();
+
+	timings.geometry  = GpuProfiler::GetMs("G-buffer");
+	timings.lighting  = GpuProfiler::GetMs("Tiled lighting");
+	timings.composite = GpuProfiler::GetMs("Composite");
+}
+
+// (Re)create the G-buffer and lit image at the framebuffer size.
+void SceneRenderer::ResizeTargets(const int& _width, const int& _height)
+{
+	if (_width == width && _height == height && gBuffer != 0) return;
+
+	DeleteTargets();
+	if (_width <= 0 || _height <= 0) return;
+
+	width  = _width;
+	height = _height;
+
+	auto createTarget = [](GLuint& texture, const GLenum& format)
+	{
+		glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+		glTextureStorage2D(texture, 1, format, width, height);
+		glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	};
+
+	// Albedo, world normal packed to [0, 1] and depth, same depth format as the default framebuffer.
+	createTarget(albedoTexture, GL_RGBA8);
+	createTarget(normalTexture, GL_RGB10_A2);
+	createTarget(depthTexture,  GL_DEPTH24_STENCIL8);
+	createTarget(litTexture,    GL_RGBA8);
+
+	const GLenum drawBuffers[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+	glCreateFramebuffers(1, &gBuffer);
+	glNamedFramebufferTexture(gBuffer, GL_COLOR_ATTACHMENT0, albedoTexture, 0);
+	glNamedFramebufferTexture(gBuffer, GL_COLOR_ATTACHMENT1, normalTexture, 0);
+	glNamedFramebufferTexture(gBuffer, GL_DEPTH_STENCIL_ATTACHMENT, depthTexture, 0);
+	glNamedFramebufferDrawBuffers(gBuffer, 2, drawBuffers);
+
+	glCreateFramebuffers(1, &litFramebuffer);
+	glNamedFramebufferTexture(litFramebuffer, GL_COLOR_ATTACHMENT0, litTexture, 0);
+
+	if (glCheckNamedFramebufferStatus(gBuffer, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+	{
+		Log(LogType::ERROR, "Deferred G-buffer is incomplete, falling back to forward rendering.");
+		DeleteTargets();
+		deferredFailed = true;
+	}
+}
+
+void SceneRenderer::DeleteTargets()
+{
+	GLuint textures[] = { albedoTexture, normalTexture, depthTexture, litTexture };
+	glDeleteTextures(4, textures);
+	GLState::Invalidate();
+	glDeleteFramebuffers(1, &gBuffer);
+	glDeleteFramebuffers(1, &litFramebuffer);
+
+	albedoTexture = normalTexture = depthTexture = litTexture = 0;
+	gBuffer = litFramebuffer = 0;
+	width = height = 0;
+}
\ No newline at end of file
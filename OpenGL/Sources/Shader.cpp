@@ -5,6 +5,7 @@
 #include <string>
 
 #include <Debug.h>
+#include <CpuProfiler.h>
 #include <Shader.h>
 
 using namespace std;
@@ -20,8 +21,9 @@ Shader::Shader()
 	  m_type(ShaderType::EmptyShader)
 { }
 
-Shader::Shader(const char* path, const ShaderType& type)
-	  : m_type(type)
+Shader::Shader(const char* path, const ShaderType& type, const string& defines)
+	  : m_type(type),
+	    m_defines(defines)
 {
 	Create(path);
 }
@@ -32,20 +34,18 @@ Shader::Shader(const char* path, const ShaderType& type)
 
 void Shader::Create(const char* path)
 {
+	PROFILE_FUNCTION();
+
 	// Specifies the type of shader to be created.
 	switch(m_type)
 	{
 		case ShaderType::VertexShader:   SetVertexShader();   break;
 		case ShaderType::FragmentShader: SetFragmentShader(); break;
+		case ShaderType::ComputeShader:  SetComputeShader();  break;
 	}
 
-	// Read shader file content into a temporary string.
-	ifstream file(path);
-	Assert(file.is_open(), string("Can't open shader file.") + path);
-
-	// Convert the file buffer to a single string.
-	ostringstream source; source << file.rdbuf();
-	string src = source.str(); file.close();
+	// Read shader source with its defines.
+	string src = ReadSource(path, m_defines);
 
 	// Compile and check shader source code.
 	const char* shaderSource = src.c_str();
@@ -68,6 +68,7 @@ int Shader::GetShader() { return m_shader; }
 
 void Shader::SetVertexShader  () { m_shader = glCreateShader(GL_VERTEX_SHADER);   }
 void Shader::SetFragmentShader() { m_shader = glCreateShader(GL_FRAGMENT_SHADER); }
+void Shader::SetComputeShader () { m_shader = glCreateShader(GL_COMPUTE_SHADER);  }
 
 bool Shader::CheckShaderCompilation()
 {
@@ -83,4 +84,24 @@ bool Shader::CheckShaderCompilation()
 	}
 
 	return true;
+}
+
+string Shader::ReadSource(const char* path, const string& defines)
+{
+	// Read shader file content into a temporary string.
+	ifstream file(path);
+	Assert(file.is_open(), string("Can't open shader file.") + path);
+
+	// Convert the file buffer to a single string.
+	ostringstream source; source << file.rdbuf();
+	string src = source.str(); file.close();
+
+	// Inject defines right after the #version directive, which must stay first.
+	if (!defines.empty())
+	{
+		size_t versionEnd = src.find('\n');
+		src.insert(versionEnd == string::npos ? src.size() : versionEnd + 1, defines);
+	}
+
+	return src;
 }
\ No newline at end of file
@@ -0,0 +1,88 @@
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <Debug.h>
+#include <ResourceManager.h>
+#include <ShaderReflection.h>
+
+using namespace std;
+using namespace Core::Debug;
+using namespace Resources;
+
+// ===================================================================
+// ShaderReflection public methods.
+// ===================================================================
+
+void ShaderReflection::Reflect(const GLuint& program)
+{
+	uniforms.clear();
+	blocks.clear();
+
+	// Default block uniforms (block members are owned by their buffer).
+	GLint count = 0;
+	glGetProgramInterfaceiv(program, GL_UNIFORM, GL_ACTIVE_RESOURCES, &count);
+
+	const GLenum uniformProps[] = { GL_NAME_LENGTH, GL_TYPE, GL_ARRAY_SIZE, GL_LOCATION, GL_BLOCK_INDEX };
+	for (GLint i = 0; i < count; i++)
+	{
+		GLint values[5];
+		glGetProgramResourceiv(program, GL_UNIFORM, i, 5, uniformProps, 5, NULL, values);
+		if (values[4] != -1) continue;
+
+		string name(values[0], '\0');
+		glGetProgramResourceName(program, GL_UNIFORM, i, values[0], NULL, name.data());
+		name.pop_back(); // Null terminator.
+
+		// Arrays of basic types are reported as "name[0]".
+		if (values[2] > 1 && name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0)
+			name.resize(name.size() - 3);
+
+		uniforms.push_back({ name, values[3], (GLenum)values[1], values[2] });
+	}
+
+	sort(uniforms.begin(), uniforms.end(), [](const UniformInfo& a, const UniformInfo& b) { return a.name < b.name; });
+
+	// Uniform and shader storage blocks.
+	const GLenum interfaces[] = { GL_UNIFORM_BLOCK, GL_SHADER_STORAGE_BLOCK };
+	const GLenum blockProps[] = { GL_NAME_LENGTH, GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE };
+	for (GLenum interface : interfaces)
+	{
+		glGetProgramInterfaceiv(program, interface, GL_ACTIVE_RESOURCES, &count);
+		for (GLint i = 0; i < count; i++)
+		{
+			GLint values[3];
+			glGetProgramResourceiv(program, interface, i, 3, blockProps, 3, NULL, values);
+
+			string name(values[0], '\0');
+			glGetProgramResourceName(program, interface, i, values[0], NULL, name.data());
+			name.pop_back();
+
+			blocks.push_back({ name, interface, values[1], values[2] });
+		}
+	}
+
+	Log(LogType::INFO, "Reflected shader program " + to_string(program) + ": " + to_string(uniforms.size()) + " uniforms, " + to_string(blocks.size()) + " blocks.");
+}
+
+GLint ShaderReflection::GetLocation(const string& name) const
+{
+	auto it = lower_bound(uniforms.begin(), uniforms.end(), name, [](const UniformInfo& a, const string& b) { return a.name < b; });
+	if (it == uniforms.end() || it->name != name) return -1;
+	return it->location;
+}
+
+GLint ShaderReflection::FindLocation(const GLuint& program, const string& name)
+{
+	ShaderReflection* reflection = ResourceManager::GetReflection(program);
+	return reflection ? reflection->GetLocation(name) : -1;
+}
+
+const BlockInfo* ShaderReflection::GetBlock(const string& name) const
+{
+	for (const BlockInfo& block : blocks)
+		if (block.name == name) return &block;
+	return nullptr;
+}
\ No newline at end of file
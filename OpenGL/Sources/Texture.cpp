@@ -3,7 +3,9 @@
 
 #include <string>
 
+#include <CpuProfiler.h>
 #include <ResourceManager.h>
+#include <GLState.h>
 #include <Texture.h>
 
 using namespace std;
@@ -25,6 +27,8 @@ Texture::Texture(const char* path) { Create(path); }
 
 void Texture::Create(const char* path)
 {
+	PROFILE_FUNCTION();
+
 	// Determies the number of the file.
 	string sPath(path);
 	if      (sPath.find(".jpg") != string::npos) m_channels = 3;
@@ -47,6 +51,9 @@ void Texture::Create(const char* path)
 	glGenerateMipmap(GL_TEXTURE_2D);
 	stbi_image_free(data);
 
+	// Bound to the active unit behind the state cache.
+	Renderer::GLState::Invalidate();
+
 	Assert(m_texture != NULL, "Can't bind m_texture to GL context.");
 }
 
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <string>
+
+#include <Vector3.h>
+#include <Matrix.h>
+#include <ShaderReflection.h>
+#include <Uniform.h>
+
+// ===================================================================
+// Uniform constructors.
+// ===================================================================
+
+template<typename T> inline Resources::Uniform<T>::Uniform()
+	: m_program(0), m_location(-1)
+{ }
+
+template<typename T> inline Resources::Uniform<T>::Uniform(const GLuint& program, const std::string& name)
+	: m_program(program), m_location(ShaderReflection::FindLocation(program, name))
+{ }
+
+template<typename T> inline bool Resources::Uniform<T>::IsActive() const { return m_location != -1; }
+
+// ===================================================================
+// Uniform typed setters (inactive uniforms are ignored by GL).
+// ===================================================================
+
+template<> inline void Resources::Uniform<int>::Set(const int& value) const
+{
+	glProgramUniform1i(m_program, m_location, value);
+}
+
+template<> inline void Resources::Uniform<float>::Set(const float& value) const
+{
+	glProgramUniform1f(m_program, m_location, value);
+}
+
+template<> inline void Resources::Uniform<Core::Maths::Vector3>::Set(const Core::Maths::Vector3& value) const
+{
+	glProgramUniform3fv(m_program, m_location, 1, &value.x);
+}
+
+template<> inline void Resources::Uniform<Core::Maths::Matrix4>::Set(const Core::Maths::Matrix4& value) const
+{
+	glProgramUniformMatrix4fv(m_program, m_location, 1, GL_FALSE, &value.m[0][0]);
+}
\ No newline at end of file
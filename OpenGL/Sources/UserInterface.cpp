@@ -6,11 +6,27 @@
 #include <GLFW/glfw3.h>
 
 #include <vector>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <cstdlib>
 
 #include <Arithmetic.h>
 #include <SceneGraph.h>
+#include <ModelManager.h>
+#include <CullingBenchmark.h>
+#include <GpuCuller.h>
+#include <LightManager.h>
+#include <SceneRenderer.h>
+#include <ResolutionScaler.h>
+#include <FrameRing.h>
+#include <GLState.h>
+#include <FrameQueue.h>
+#include <JobSystem.h>
+#include <GpuProfiler.h>
+#include <CpuProfiler.h>
+#include <CameraRecording.h>
+#include <FramePacer.h>
 #include <Transform.h>
 #include <UserInterface.h>
 
@@ -22,6 +38,7 @@ using namespace ImGui;
 // User Interface static declaration.
 int UserInterface::maxMessages;
 vector<pair<Core::Debug::LogType, string>> UserInterface::logBuffer;
+mutex UserInterface::logMutex;
 
 // ===================================================================
 // User interface public main methods.
@@ -38,6 +55,9 @@ void UserInterface::Init(GLFWwindow* window, const int& glMajorVersion, const in
 	ImGui_ImplGlfw_InitForOpenGL(window, true);
 	ImGui_ImplOpenGL3_Init(glVersion.c_str());
 
+	// Created while the context is current here, the render thread only draws with them.
+	ImGui_ImplOpenGL3_CreateDeviceObjects();
+
 	// Set ImGui style.
 	SetImGuiStyle(style);
 
@@ -49,10 +69,7 @@ void UserInterface::Update()
 {
 	// Managers.
 	ManageLogs();
-}
 
-void UserInterface::Draw()
-{
 	ImGui_ImplOpenGL3_NewFrame();
 	ImGui_ImplGlfw_NewFrame();
 	NewFrame();
@@ -67,6 +84,16 @@ void UserInterface::Draw()
 			DisplaySceneGraph();
 			EndTabItem();
 		}
+		if (BeginTabItem("Stats"))
+		{
+			DisplayStats();
+			EndTabItem();
+		}
+		if (BeginTabItem("Profiler"))
+		{
+			DisplayProfiler();
+			EndTabItem();
+		}
 		if (BeginTabItem("Logs"))
 		{
 			DisplayLogs();
@@ -77,8 +104,32 @@ void UserInterface::Draw()
 	End();
 
 	Render();
-	ImGui_ImplOpenGL3_RenderDrawData(GetDrawData());
-	EndFrame();
+}
+
+void UserInterface::Capture(UIDrawData& output)
+{
+	Release(output);
+
+	ImDrawData* drawData = GetDrawData();
+	output.drawData = *drawData;
+	for (int i = 0; i < drawData->CmdListsCount; i++)
+		output.lists.push_back(drawData->CmdLists[i]->CloneOutput());
+
+	output.drawData.CmdLists = output.lists.data();
+}
+
+void UserInterface::Draw(UIDrawData& drawData)
+{
+	Renderer::GpuZone zone("ImGui");
+	if (drawData.drawData.Valid) ImGui_ImplOpenGL3_RenderDrawData(&drawData.drawData);
+}
+
+// Draw lists are freed by the thread building the interface.
+void UserInterface::Release(UIDrawData& drawData)
+{
+	for (ImDrawList* list : drawData.lists) IM_DELETE(list);
+	drawData.lists.clear();
+	drawData.drawData = ImDrawData();
 }
 
 void UserInterface::Unload()
@@ -116,6 +167,7 @@ void UserInterface::SetImGuiStyle(const UIStyle& style)
 void UserInterface::ManageLogs()
 {
 	// Logs output limited to max messages propertie.
+	lock_guard<mutex> lock(logMutex);
 	if (logBuffer.size() > maxMessages)
 		logBuffer.assign(logBuffer.begin() + 1, logBuffer.end() - 1);
 }
@@ -123,6 +175,7 @@ void UserInterface::ManageLogs()
 void UserInterface::DisplayLogs()
 {
 	BeginChild("Logs", GetContentRegionAvail(), false);
+	lock_guard<mutex> lock(logMutex);
 	for (auto& it : logBuffer)
 	{
 		// Push message color.
@@ -170,3 +223,230 @@ void UserInterface::DisplaySceneGraph()
 	}
 	EndChild();
 }
+
+void UserInterface::DisplayStats()
+{
+	// Render thread results of the last presented frame.
+	const Renderer::RenderStats&      renderStats = Renderer::FrameQueue::renderStats;
+	const Renderer::RenderQueueStats& stats       = renderStats.draws;
+
+	BeginChild("Stats", GetContentRegionAvail(), false);
+	Text("Frame time: %.3f ms (%.1f FPS)", 1000.f / GetIO().Framerate, GetIO().Framerate);
+	Text("Frame ring:         %zu / %zu KB (%d regions)", renderStats.frameRing.used >> 10, renderStats.frameRing.regionSize >> 10, FRAME_RING_REGIONS);
+	Text("Ring fence waits:   %u, overflows: %u", renderStats.frameRing.fenceWaits, renderStats.frameRing.overflows);
+	Separator();
+
+	const Renderer::FrameLatencyStats& latency = renderStats.latency;
+	Text("Input to present:   %.3f ms (%u / %d queued)", latency.inputToPresent, latency.depth, FRAME_QUEUE_DEPTH);
+	Text("Queued / render:    %.3f / %.3f ms", latency.queued, latency.render);
+	Text("Main / render wait: %.3f / %.3f ms", latency.mainWait, latency.renderWait);
+	Separator();
+	DisplayJobs();
+	Separator();
+	Text("Visible models:     %u", Renderer::ModelManager::cullingStats.visible);
+	Text("Culled models:      %u", Renderer::ModelManager::cullingStats.culled);
+	Text("BVH nodes tested:   %u (height %d)", Renderer::ModelManager::cullingStats.tested, SceneGraph::bvh.GetHeight());
+	Separator();
+	Checkbox("GPU culling", &Renderer::ModelManager::gpuCulling);
+	if (Renderer::ModelManager::gpuCulling)
+	{
+		Checkbox("Hi-Z culling (last frame depth)", &Renderer::GpuCuller::hiZCulling);
+		Text("Draw count from GPU: %s", Renderer::GpuCuller::indirectCount ? "yes" : "no (fallback)");
+	}
+	Checkbox("Occlusion culling", &Renderer::ModelManager::occlusionCulling);
+	Text("Occluder triangles: %u", Renderer::ModelManager::occlusionStats.occluderTriangles);
+	Text("Occluded models:    %u / %u", Renderer::ModelManager::occlusionStats.occluded, Renderer::ModelManager::occlusionStats.tested);
+	Text("Occlusion raster:   %.3f ms", Renderer::ModelManager::occlusionStats.rasterMs);
+	if (Button("Run culling benchmark"))
+		Core::Debug::CullingBenchmark::requested = true;
+	Checkbox("Record camera (" CAMERA_RECORDING_PATH ", replay with --benchmark)", &Core::CameraRecording::recording);
+	Separator();
+	Text("Render queue items: %u", stats.items);
+	Text("Instanced batches:  %u", stats.batches);
+	Text("Multi-draw calls:   %u", stats.multiDraws);
+	Text("Triangles:          %u", stats.triangles);
+	Text("State binds:        %u", stats.binds);
+	Text("Binds avoided:      %u", stats.bindsAvoided);
+
+	// Packets of the command buffers replayed by the last frame.
+	const Renderer::CommandStats& commands = renderStats.commands;
+	Checkbox("Validate command buffers", &Renderer::ModelManager::validateCommands);
+	if (!commands.valid) TextColored(ImVec4(1, 0.3f, 0.3f, 1), "Invalid command buffer, see logs.");
+	if (TreeNode("Commands", "Command packets:    %u (%zu bytes, %u recorded buffers)", commands.packets, commands.bytes, commands.buffers))
+	{
+		for (size_t i = 0; i < (size_t)Renderer::CommandType::Count; i++)
+			Text("%-21s %u", Renderer::CommandBuffer::GetTypeName((Renderer::CommandType)i), commands.counts[i]);
+		TreePop();
+	}
+
+	// Binds and capabilities matching the shadowed context state are not issued.
+	const Renderer::GLStateStats& glState = renderStats.glState;
+	unsigned int issued = 0, skipped = 0;
+	for (size_t i = 0; i < (size_t)Renderer::GLStateCall::Count; i++)
+	{
+		issued  += glState.issued[i];
+		skipped += glState.skipped[i];
+	}
+	if (TreeNode("GLState", "GL state calls:     %u issued, %u skipped", issued, skipped))
+	{
+		for (size_t i = 0; i < (size_t)Renderer::GLStateCall::Count; i++)
+			Text("%-21s %u issued, %u skipped", Renderer::GLState::GetCallName((Renderer::GLStateCall)i), glState.issued[i], glState.skipped[i]);
+		TreePop();
+	}
+	Separator();
+	DisplayRenderPath();
+	Separator();
+	DisplayResolution();
+	Separator();
+	DisplayFramePacing();
+	Separator();
+	DisplayLights();
+	EndChild();
+}
+
+
+void UserInterface::DisplayLights()
+{
+	// Lights loaded with the scene are kept when removing spawned ones.
+	static size_t sceneLights = Renderer::LightManager::lights.size();
+
+	Text("Lights:             %zu", Renderer::LightManager::lights.size());
+	Text("Light clusters:     %dx%dx%d", CLUSTER_X, CLUSTER_Y, CLUSTER_Z);
+	if (Button("Spawn 1024 point lights"))
+	{
+		for (int i = 0; i < 1024; i++)
+		{
+			auto random = [](float min, float max) { return min + (max - min) * (float)rand() / RAND_MAX; };
+			Core::Maths::Vector3 color(random(0, 1), random(0, 1), random(0, 1));
+			Core::Maths::Vector3 position(random(-60, 60), random(1, 30), random(-60, 60));
+			Renderer::LightManager::AddLight(Renderer::Light(Core::Maths::Vector3(), color, color * 0.5f, position, 12, 0, 0.05f));
+		}
+	}
+	SameLine();
+	if (Button("Remove spawned lights"))
+		Renderer::LightManager::Clear((unsigned int)sceneLights);
+}
+
+// GPU time of every profiled zone over the last frames, nested zones are indented.
+void UserInterface::DisplayProfiler()
+{
+	BeginChild("Profiler", GetContentRegionAvail(), false);
+
+	if (Button("Export CSV")) Renderer::GpuProfiler::exportRequested = true;
+	SameLine();
+	Text("%s, %u frames dropped (results late)", GPU_PROFILER_CSV_PATH, Renderer::FrameQueue::renderStats.gpuDroppedFrames);
+#ifdef ENABLE_PROFILER
+	if (Button("Export CPU trace")) Core::Debug::CpuProfiler::exportRequested = true;
+	SameLine();
+	Text("%s, last %d zones per thread", CPU_PROFILER_TRACE_PATH, CPU_PROFILER_EVENTS);
+#endif
+	Separator();
+
+	const vector<Renderer::GpuZoneHistory>& history = Renderer::FrameQueue::renderStats.gpuHistory;
+	unsigned int historyFrame = Renderer::FrameQueue::renderStats.gpuHistoryFrame;
+	for (size_t i = 0; i < history.size(); i++)
+	{
+		const Renderer::GpuZoneHistory& zone = history[i];
+		unsigned int last = (historyFrame + GPU_PROFILER_HISTORY - 1) % GPU_PROFILER_HISTORY;
+
+		float peak = 0.1f;
+		for (float ms : zone.ms) peak = max(peak, ms);
+
+		char overlay[32];
+		snprintf(overlay, sizeof(overlay), "%.3f ms", zone.ms[last]);
+		Indent(zone.depth * 12.f + 1);
+		PlotLines(zone.name, zone.ms, GPU_PROFILER_HISTORY, historyFrame, overlay, 0.f, peak * 1.2f, ImVec2(0, 40));
+		Unindent(zone.depth * 12.f + 1);
+	}
+
+	EndChild();
+}
+
+// Busy fraction of every job system thread over the last frames.
+void UserInterface::DisplayJobs()
+{
+	const vector<Core::JobThreadTrace>& trace = Core::JobSystem::trace;
+	unsigned int workerCount = Core::JobSystem::GetWorkerCount();
+
+	if (!TreeNode("Jobs", "Job system:         %u workers", workerCount)) return;
+
+	for (size_t i = 0; i < trace.size(); i++)
+	{
+		string name = i < workerCount ? "Worker " + to_string(i) : (i == workerCount ? "Main" : "Render");
+		string overlay = to_string(trace[i].jobs) + " jobs, " + to_string(trace[i].steals) + " steals";
+
+		PlotLines(name.c_str(), trace[i].utilization, JOB_TRACE_FRAMES, Core::JobSystem::traceFrame, overlay.c_str(), 0.f, 1.f, ImVec2(0, 30));
+	}
+	TreePop();
+}
+
+void UserInterface::DisplayRenderPath()
+{
+	Renderer::RenderPath& path = Renderer::SceneRenderer::path;
+	const Renderer::RenderStats& renderStats = Renderer::FrameQueue::renderStats;
+	const Renderer::RenderPassTimings& timings = renderStats.timings;
+
+	Text("Render path:");
+	SameLine();
+	if (RadioButton("Forward",  path == Renderer::RenderPath::Forward))  path = Renderer::RenderPath::Forward;
+	SameLine();
+	if (RadioButton("Deferred", path == Renderer::RenderPath::Deferred)) path = Renderer::RenderPath::Deferred;
+
+	if (path == Renderer::RenderPath::Forward)
+		Checkbox("Depth pre-pass", &Renderer::SceneRenderer::depthPrepass);
+	else if (renderStats.deferredFailed)
+		TextColored(ImVec4(1, 0.3f, 0.3f, 1), "Deferred targets unsupported, rendering forward.");
+
+	// Timings of the path of the last presented frame.
+	if (renderStats.path == Renderer::RenderPath::Forward)
+	{
+		Text("Light assignment:   %.3f ms", timings.lightAssignment);
+		if (Renderer::SceneRenderer::depthPrepass)
+			Text("Depth pre-pass:     %.3f ms", timings.prepass);
+		Text("Forward shading:    %.3f ms", timings.forward);
+		Text("GPU total:          %.3f ms", timings.lightAssignment + timings.prepass + timings.forward);
+	}
+	else
+	{
+		Text("G-buffer:           %.3f ms", timings.geometry);
+		Text("Tiled lighting:     %.3f ms", timings.lighting);
+		Text("Composite:          %.3f ms", timings.composite);
+		Text("GPU total:          %.3f ms", timings.geometry + timings.lighting + timings.composite);
+	}
+}
+
+void UserInterface::DisplayResolution()
+{
+	Renderer::ResolutionSettings& settings = Renderer::ResolutionScaler::settings;
+
+	Checkbox("Dynamic resolution", &settings.enabled);
+	if (!settings.enabled) return;
+
+	SliderFloat("Target GPU frame", &settings.targetMs, 4.f, 50.f, "%.1f ms");
+	SliderFloat("Min scale", &settings.minScale, 0.25f, 1.f, "%.2f");
+	SliderFloat("Max scale", &settings.maxScale, 0.25f, 1.f, "%.2f");
+	settings.maxScale = max(settings.maxScale, settings.minScale);
+
+	const Renderer::RenderStats& renderStats = Renderer::FrameQueue::renderStats;
+	Text("Scene resolution:   %d x %d (%.0f%%)", renderStats.sceneWidth, renderStats.sceneHeight, renderStats.resolutionScale * 100);
+	Text("Upscale:            %.3f ms", Renderer::GpuProfiler::GetMs(renderStats.gpuZones, "Upscale"));
+}
+
+void UserInterface::DisplayFramePacing()
+{
+	Core::FramePacingSettings& settings = Core::FramePacer::settings;
+	const Core::FramePacingStats& stats = Core::FramePacer::stats;
+
+	// Adaptive vsync tears late frames instead of waiting for the next vertical blank, vsync when unsupported.
+	int swapMode = (int)settings.swapMode;
+	if (Combo("Swap interval", &swapMode, "Immediate\0VSync\0Half rate\0Adaptive\0"))
+		settings.swapMode = (Core::SwapMode)swapMode;
+
+	SliderFloat("Frame limit", &settings.frameLimit, 0.f, 240.f, settings.frameLimit > 0 ? "%.0f fps" : "Off");
+	if (settings.frameLimit > 0)
+		Text("Limiter error:      %.3f ms (sleep %.2f ms)", stats.limiterErrorMs, stats.sleepEstimateMs);
+
+	Checkbox("Render on demand", &settings.onDemand);
+	if (settings.onDemand)
+		Text("On-demand frames:   %u rendered, %u skipped", stats.rendered, stats.skipped);
+}
\ No newline at end of file
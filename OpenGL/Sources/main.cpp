@@ -1,15 +1,20 @@
 #include <crtdbg.h>
+#include <Headless.h>
 #include <App.h>
 
 using namespace std;
 using namespace Core;
 
-int main()
+int main(int argc, char** argv)
 {
 	_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
 	// _CrtSetBreakAlloc(770);
 
-	App app(4, 5, false);
+	// Headless runs are configured from the command line, see Headless::ParseArguments.
+	HeadlessSettings headless;
+	if (!Headless::ParseArguments(argc, argv, headless)) return 1;
+
+	App app(4, 5, false, true, headless);
 	app.Run();
 	return 0;
 }
\ No newline at end of file